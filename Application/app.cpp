@@ -1,5 +1,10 @@
 #include "main.h"
 #include "uart_handler.h"
+#include "command_handler.h"
+#include "cam_scheduler.h"
+
+/* Bekleyen komutlarin zaman asimi kontrol periyodu (ms) */
+#define APP_TIMEOUT_CHECK_PERIOD_MS  (100U)
 
 
 
@@ -14,18 +19,57 @@ void app_entry(){
 //			led_tick = HAL_GetTick();
 //		}
 //	}
+	uint32_t timeout_tick = HAL_GetTick();
+
+	CommandHandler_Init();
+	CamSched_Init();
 	UART_Handler_Init();
 	for(;;)
 	{
+		/* ISR'larin biraktigi tam frame'ler: dogrulama, ceviri, gonderim */
+		UART_Handler_Process();
 
+		/* Cevapsiz kalan komutlari periyodik olarak dusur */
+		if ((HAL_GetTick() - timeout_tick) >= APP_TIMEOUT_CHECK_PERIOD_MS) {
+			timeout_tick = HAL_GetTick();
+			CamSched_OnTimeouts(CommandHandler_CheckTimeouts());
+		}
 	}
 
 }
 /*Low-level uart implementasyonlari.*/
 extern "C"
-void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart){
-	UART_Handler_RxCplt(huart);
+void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size){
+	UART_Handler_RxEvent(huart, Size);
+}
+
+extern "C"
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef *huart){
+	UART_Handler_TxCplt(huart);
+}
+
+/* USART IRQ'dan receiver timeout (RTOF) geldiginde cagrilir */
+extern "C"
+void rx_timeout_callback(UART_HandleTypeDef *huart){
+	UART_Handler_RxTimeout(huart);
+}
+
+#if (UART_DRIVER_LL == 1)
+/* Register seviyesi backend: USART IRQ'nun alim kismi.
+   1 = kesme tamamen islendi, 0 = HAL_UART_IRQHandler da cagrilmali */
+extern "C"
+uint8_t uart_ll_irq_callback(UART_HandleTypeDef *huart){
+	return UART_Handler_IrqLL(huart) ? 1U : 0U;
+}
+#endif
+
+#if (UART_IRQ_CYCLE_STATS == 1)
+/* USART IRQ giris-cikis cevrim sayisi */
+extern "C"
+void uart_irq_cycles_callback(UART_HandleTypeDef *huart, uint32_t cycles){
+	UART_Handler_IrqCycles(huart, cycles);
 }
+#endif
 
 extern "C"
 void tick_callback(){
@@ -0,0 +1,11 @@
+/**
+ * @file commands_check.cpp
+ * @brief Komut tablosu header'larinin derleme aninda kontrolu
+ *
+ * commands_xcore.h ve commands_vpc_ext.h sahada yakalanmis frame'lerin
+ * LEN/XOR/checksum kontrollerini (static_assert) tasir; bu header'lari
+ * include eden baska kaynak olmadigindan kontroller ancak burada derlenir.
+ * Calisma aninda kullanilmaz; header tablolari --gc-sections ile atilir.
+ */
+
+#include "commands_vpc_ext.h"   /* commands_xcore.h'yi de getirir */
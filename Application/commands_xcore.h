@@ -4,6 +4,7 @@
 
 #include <stdint.h>
 #include <cstdint>
+#include "translator_dsl.h"   /* TrCtrlAck, TrCtrlResponse (OldPacket_* ile) */
 
 
 constexpr uint8_t serialNumber[] = {0x00, 0x00};
@@ -36,23 +37,38 @@ constexpr uint8_t gamm_corr[]={0x00,0x3D};
 constexpr uint8_t DDE_ctrl[]={0x00,0x3E};
 constexpr uint8_t DDE_grade[]={0x00,0x3F};
 
-uint8_t NUC_shutter_setter_rx[] = {0x55, 0x05, 0x00, 0x16, 0x33, 0x01, 0xA4, 0xEB, 0xAA};
-uint8_t zoom_setter_rx[] = {0x55,0x05,0x00,0x2A,0x33,0x01,0xB8,0xEB,0xAA};
-uint8_t image_palette_black_white_hot_setter_rx[] = {0x55, 0x05, 0x00, 0x2D, 0x33, 0x01, 0xBB, 0xEB, 0xAA};
-uint8_t settings_saver_rx[]={0x55, 0x05, 0x00, 0x11, 0x33, 0x01, 0x9F, 0xEB, 0xAA};
-uint8_t brightness_setter_rx[]={0x55,0x05,0x00,0x3C,0x33,0x01,0xCA,0xEB,0xAA};
+/* Kontrol tarafi yanitlari: derleme aninda uretilir (translator_dsl.h),
+   checksum elle yazilmaz. Frame bytelari .b, boyu sizeof(.b). */
+constexpr auto NUC_shutter_setter_rx = TrCtrlAck(0x16);
+constexpr auto zoom_setter_rx = TrCtrlAck(0x2A);
+constexpr auto image_palette_black_white_hot_setter_rx = TrCtrlAck(0x2D);
+constexpr auto settings_saver_rx = TrCtrlAck(0x11);
+constexpr auto brightness_setter_rx = TrCtrlAck(0x3C);
 
 
 // For unmating commands. NOTE: These payloads (byte 5 and byte 6) are exchangeable!!
-uint8_t oto_nuc_temp_ack_from_read[]={0x55, 0x05, 0x00, 0x18, 0x33, 0x14, 0xB9, 0xEB, 0xAA};
-uint8_t contrast_step_ack_from_read[]={0x55, 0x05, 0x00, 0x40, 0x33, 0x01, 0xCE, 0xEB, 0xAA};
-uint8_t brightness_step_ack_from_read[]={0x55, 0x05, 0x00, 0x41, 0x33, 0x01, 0xCF, 0xEB, 0xAA};
-uint8_t zoom_ack_from_read[]={0x55, 0x06, 0x00, 0x2A, 0x33, 00, 0x00, 0x1C, 0xEB, 0xAA};
-uint8_t agc_ack_from_read[]={0x55, 0x05, 0x00, 0x3A, 0x33, 0x00, 0xC7, 0xEB, 0xAA};
-uint8_t gamma_corr_ack_from_read[]={0x55, 0x05, 0x00, 0x3D, 0x33, 0x00, 0xD4, 0xEB, 0xAA};
-uint8_t DDE_ctrl_ack_from_read[]= {0x55, 0x05, 0x00, 0x3E, 0x33, 0x00, 0xCC, 0xEB, 0xAA};
-uint8_t DDE_grade_ack_from_read[]={0x55, 0x05, 0x00, 0x3F, 0x33, 0x00, 0xCE, 0xEB, 0xAA};
-uint8_t img_filter_ack_from_read[]={0x55, 0x05, 0x00, 0x31, 0x33, 0x00, 0xBE, 0xEB, 0xAA};
+constexpr auto oto_nuc_temp_ack_from_read = TrCtrlAck(0x18, 0x14);
+constexpr auto contrast_step_ack_from_read = TrCtrlAck(0x40, 0x01);
+constexpr auto brightness_step_ack_from_read = TrCtrlAck(0x41, 0x01);
+constexpr uint8_t zoom_ack_from_read_pl[] = {0x00, 0x00};
+constexpr auto zoom_ack_from_read = TrCtrlResponse(0x2A, zoom_ack_from_read_pl);
+constexpr auto agc_ack_from_read = TrCtrlAck(0x3A, 0x00);
+constexpr auto gamma_corr_ack_from_read = TrCtrlAck(0x3D, 0x00);
+constexpr auto DDE_ctrl_ack_from_read = TrCtrlAck(0x3E, 0x00);
+constexpr auto DDE_grade_ack_from_read = TrCtrlAck(0x3F, 0x00);
+constexpr auto img_filter_ack_from_read = TrCtrlAck(0x31, 0x00);
+
+/* Kontrol cihazinin kabul ettigi (sahada yakalanmis) checksum'lar */
+static_assert(NUC_shutter_setter_rx.b[6] == 0xA4U, "NUC ACK");
+static_assert(zoom_setter_rx.b[6] == 0xB8U, "zoom ACK");
+static_assert(image_palette_black_white_hot_setter_rx.b[6] == 0xBBU, "palette ACK");
+static_assert(settings_saver_rx.b[6] == 0x9FU, "settings saver ACK");
+static_assert(brightness_setter_rx.b[6] == 0xCAU, "brightness ACK");
+static_assert(oto_nuc_temp_ack_from_read.b[6] == 0xB9U, "oto NUC temp");
+static_assert(contrast_step_ack_from_read.b[6] == 0xCEU, "contrast step");
+static_assert(brightness_step_ack_from_read.b[6] == 0xCFU, "brightness step");
+static_assert(agc_ack_from_read.b[6] == 0xC7U, "AGC");
+static_assert(img_filter_ack_from_read.b[6] == 0xBEU, "image filter");
 
 
 //Variable for save parameter
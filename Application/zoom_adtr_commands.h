@@ -1,5 +1,9 @@
 #ifndef ZOOM_ADTR_COMMANDS_H_
 #define ZOOM_ADTR_COMMANDS_H_
+
+#include <stdint.h>
+#include <array>
+
 /*
  * @brief 0.1 ondalık artışlı zoom komutlarını array'de tutma işini yapar.
  *
@@ -76,6 +76,23 @@ void Error_Handler(void);
 #define ZOOM_CTL_GPIO_Port GPIOA
 #define SHUTTER_CTL_Pin GPIO_PIN_5
 #define SHUTTER_CTL_GPIO_Port GPIOA
+/* UART alim backend'i (derleme aninda secilir, -D ile ezilebilir):
+   0 = HAL + dairesel DMA/IDLE (varsayilan), 1 = register seviyesi RXNE kesmesi */
+#ifndef UART_DRIVER_LL
+#define UART_DRIVER_LL 0
+#endif
+/* 1 = USART kesmelerinin giris-cikis cevrim sayisini DWT ile olc */
+#ifndef UART_IRQ_CYCLE_STATS
+#define UART_IRQ_CYCLE_STATS 0
+#endif
+/* 1 = CommandHandler_ProfileTranslators: native / bytecode ceviri maliyeti (DWT) */
+#ifndef CMD_TRANSLATE_CYCLE_STATS
+#define CMD_TRANSLATE_CYCLE_STATS 0
+#endif
+/* 1 = Checksum_Benchmark: byte dongusu / kelime cekirdegi karsilastirmasi (DWT) */
+#ifndef CHECKSUM_CYCLE_STATS
+#define CHECKSUM_CYCLE_STATS 0
+#endif
 /* USER CODE END Private defines */
 
 #ifdef __cplusplus
@@ -56,6 +56,10 @@
 /* USER CODE END 0 */
 
 /* External variables --------------------------------------------------------*/
+extern DMA_HandleTypeDef hdma_usart1_rx;
+extern DMA_HandleTypeDef hdma_usart1_tx;
+extern DMA_HandleTypeDef hdma_usart2_rx;
+extern DMA_HandleTypeDef hdma_usart2_tx;
 extern UART_HandleTypeDef huart1;
 extern UART_HandleTypeDef huart2;
 /* USER CODE BEGIN EV */
@@ -201,17 +205,95 @@ void SysTick_Handler(void)
 /* please refer to the startup file (startup_stm32l4xx.s).                    */
 /******************************************************************************/
 
+/**
+  * @brief This function handles DMA1 channel4 global interrupt.
+  */
+void DMA1_Channel4_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA1_Channel4_IRQn 0 */
+
+  /* USER CODE END DMA1_Channel4_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_usart1_tx);
+  /* USER CODE BEGIN DMA1_Channel4_IRQn 1 */
+
+  /* USER CODE END DMA1_Channel4_IRQn 1 */
+}
+
+/**
+  * @brief This function handles DMA1 channel5 global interrupt.
+  */
+void DMA1_Channel5_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA1_Channel5_IRQn 0 */
+
+  /* USER CODE END DMA1_Channel5_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_usart1_rx);
+  /* USER CODE BEGIN DMA1_Channel5_IRQn 1 */
+
+  /* USER CODE END DMA1_Channel5_IRQn 1 */
+}
+
+/**
+  * @brief This function handles DMA1 channel6 global interrupt.
+  */
+void DMA1_Channel6_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA1_Channel6_IRQn 0 */
+
+  /* USER CODE END DMA1_Channel6_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_usart2_rx);
+  /* USER CODE BEGIN DMA1_Channel6_IRQn 1 */
+
+  /* USER CODE END DMA1_Channel6_IRQn 1 */
+}
+
+/**
+  * @brief This function handles DMA1 channel7 global interrupt.
+  */
+void DMA1_Channel7_IRQHandler(void)
+{
+  /* USER CODE BEGIN DMA1_Channel7_IRQn 0 */
+
+  /* USER CODE END DMA1_Channel7_IRQn 0 */
+  HAL_DMA_IRQHandler(&hdma_usart2_tx);
+  /* USER CODE BEGIN DMA1_Channel7_IRQn 1 */
+
+  /* USER CODE END DMA1_Channel7_IRQn 1 */
+}
+
 /**
   * @brief This function handles USART1 global interrupt.
   */
 void USART1_IRQHandler(void)
 {
   /* USER CODE BEGIN USART1_IRQn 0 */
-
+#if (UART_IRQ_CYCLE_STATS == 1)
+	extern void uart_irq_cycles_callback(UART_HandleTypeDef *huart, uint32_t cycles);
+	uint32_t irq_t0 = DWT->CYCCNT;
+#endif
+#if (UART_DRIVER_LL == 1)
+	/* Register seviyesi alim: RDR dogrudan framer'a. HAL sadece TX tamamlama icin cagrilir */
+	extern uint8_t uart_ll_irq_callback(UART_HandleTypeDef *huart);
+	if (uart_ll_irq_callback(&huart1) != 0U) {
+#if (UART_IRQ_CYCLE_STATS == 1)
+		uart_irq_cycles_callback(&huart1, DWT->CYCCNT - irq_t0);
+#endif
+		return;
+	}
+#else
+	/* Receiver timeout HAL'e birakilmaz (HAL RTO'yu hata sayip DMA'yi durdurur) */
+	extern void rx_timeout_callback(UART_HandleTypeDef *huart);
+	if (__HAL_UART_GET_FLAG(&huart1, UART_FLAG_RTOF) != RESET) {
+		__HAL_UART_CLEAR_FLAG(&huart1, UART_CLEAR_RTOF);
+		rx_timeout_callback(&huart1);
+	}
+#endif
   /* USER CODE END USART1_IRQn 0 */
   HAL_UART_IRQHandler(&huart1);
   /* USER CODE BEGIN USART1_IRQn 1 */
-
+#if (UART_IRQ_CYCLE_STATS == 1)
+	uart_irq_cycles_callback(&huart1, DWT->CYCCNT - irq_t0);
+#endif
   /* USER CODE END USART1_IRQn 1 */
 }
 
@@ -221,11 +303,33 @@ void USART1_IRQHandler(void)
 void USART2_IRQHandler(void)
 {
   /* USER CODE BEGIN USART2_IRQn 0 */
-
+#if (UART_IRQ_CYCLE_STATS == 1)
+	extern void uart_irq_cycles_callback(UART_HandleTypeDef *huart, uint32_t cycles);
+	uint32_t irq_t0 = DWT->CYCCNT;
+#endif
+#if (UART_DRIVER_LL == 1)
+	/* Register seviyesi alim: RDR dogrudan framer'a. HAL sadece TX tamamlama icin cagrilir */
+	extern uint8_t uart_ll_irq_callback(UART_HandleTypeDef *huart);
+	if (uart_ll_irq_callback(&huart2) != 0U) {
+#if (UART_IRQ_CYCLE_STATS == 1)
+		uart_irq_cycles_callback(&huart2, DWT->CYCCNT - irq_t0);
+#endif
+		return;
+	}
+#else
+	/* Receiver timeout HAL'e birakilmaz (HAL RTO'yu hata sayip DMA'yi durdurur) */
+	extern void rx_timeout_callback(UART_HandleTypeDef *huart);
+	if (__HAL_UART_GET_FLAG(&huart2, UART_FLAG_RTOF) != RESET) {
+		__HAL_UART_CLEAR_FLAG(&huart2, UART_CLEAR_RTOF);
+		rx_timeout_callback(&huart2);
+	}
+#endif
   /* USER CODE END USART2_IRQn 0 */
   HAL_UART_IRQHandler(&huart2);
   /* USER CODE BEGIN USART2_IRQn 1 */
-
+#if (UART_IRQ_CYCLE_STATS == 1)
+	uart_irq_cycles_callback(&huart2, DWT->CYCCNT - irq_t0);
+#endif
   /* USER CODE END USART2_IRQn 1 */
 }
 
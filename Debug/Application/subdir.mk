@@ -5,13 +5,16 @@
 
 # Add inputs and outputs from these tool invocations to the build variables 
 CPP_SRCS += \
-../Application/app.cpp 
+../Application/app.cpp \
+../Application/commands_check.cpp 
 
 OBJS += \
-./Application/app.o 
+./Application/app.o \
+./Application/commands_check.o 
 
 CPP_DEPS += \
-./Application/app.d 
+./Application/app.d \
+./Application/commands_check.d 
 
 
 # Each subdirectory must supply rules for building sources it contributes
@@ -21,7 +24,7 @@ Application/%.o Application/%.su Application/%.cyclo: ../Application/%.cpp Appli
 clean: clean-Application
 
 clean-Application:
-	-$(RM) ./Application/app.cyclo ./Application/app.d ./Application/app.o ./Application/app.su
+	-$(RM) ./Application/app.cyclo ./Application/app.d ./Application/app.o ./Application/app.su ./Application/commands_check.cyclo ./Application/commands_check.d ./Application/commands_check.o ./Application/commands_check.su
 
 .PHONY: clean-Application
 
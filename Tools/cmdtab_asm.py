@@ -0,0 +1,495 @@
+#!/usr/bin/env python3
+"""
+cmdtab_asm.py - flash komut tablosu assembler'i
+
+Metin kaynaktan (ornek: cmdtab_default.txt) User_Inc/commands_metadata.h
+formatinda tablo imaji uretir. Imaj, firmware'den ayri olarak CMDTAB flash
+sayfasina (0x0801F800, 2K) yazilir; acilista CmdTab_Load dogrular.
+
+Kaynak:
+    cmd KB0:KB1 SET|READ ANY|P0=xx QUERY ACK|ECHO|MULTI SINIF BIRLESTIR B1 B2 B3 ["aciklama"]
+        const  V            [xN]
+        copy   OFF          [xN]     (N byte kopya)
+        scale8 OFF MUL DIV  [xN]
+        lookup OFF [t0 t1 ...] [xN]
+    end
+
+QUERY: command_tracking.h'deki queryBitEnum adi (QUERY_ oneki olmadan) ya da sayi.
+SINIF: cmdPriority_t (INTERACTIVE, TRIGGER, READ, POLL), kamera gonderim sirasi.
+BIRLESTIR: COALESCE = sirada ayni parametreye yeni set gelirse yerine gecer
+(sadece SET), - = her komut kameraya gider (Manuel NUC gibi eylemler).
+Sayilar 0x ile hex, aksi halde ondalik; KB0:KB1, P0 ve B1..B3 her zaman hex.
+
+--check: tablodaki her komut, golgeledigi command_map kaydiyla
+(User_Src/command_handler.cpp) karsilastirilir. Ayni anahtar + tipte kayit
+varsa kamera komutu, query, yanit, sinif, birlestirme ve payload adimlari
+ayni olmalidir; hazir frame kumesi (frames) kullanan kayitlar bytecode ile
+dogrulanamaz, tabloya alinamaz. command_map'te olmayan komutlar yeni sayilir.
+
+Kullanim:
+    cmdtab_asm.py cmdtab_default.txt -o cmdtab.bin [--hex cmdtab.hex] [--list]
+    cmdtab_asm.py cmdtab_default.txt --check
+"""
+
+import argparse
+import os
+import re
+import shlex
+import struct
+import sys
+import zlib
+
+CMDTAB_MAGIC = 0x54444D43
+CMDTAB_VERSION = 2
+CMDTAB_MAX_ENTRIES = 32
+CMDTAB_BASE = 0x0801F800
+CMDTAB_REGION = 2048
+
+TR_CAM_PKT_MAX = 64
+CAM_PAYLOAD_MAX = TR_CAM_PKT_MAX - 6 - 2
+CTRL_PKT_MIN_SIZE = 8
+TR_CTRL_TAIL_SIZE = 3
+
+PAYACT_END, PAYACT_CONST, PAYACT_COPY, PAYACT_SCALE8, PAYACT_LOOKUP = range(5)
+TYPES = {"SET": 0, "READ": 1}
+RESPS = {"ACK": 0, "ECHO": 1, "MULTI": 2}
+PRIOS = {"INTERACTIVE": 0, "TRIGGER": 1, "READ": 2, "POLL": 3}
+CMDTAB_FLAG_COALESCE = 0x01
+FLAGS = {"COALESCE": CMDTAB_FLAG_COALESCE, "-": 0}
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+TRACKING_H = os.path.join(HERE, "..", "User_Inc", "command_tracking.h")
+HANDLER_CPP = os.path.join(HERE, "..", "User_Src", "command_handler.cpp")
+RESP_GENS = {"ResponseGen_SimpleACK": 0, "ResponseGen_EchoParam": 1, "ResponseGen_MultiParam": 2}
+
+
+class AsmError(Exception):
+    pass
+
+
+def num(tok, line):
+    try:
+        return int(tok, 16) if tok.lower().startswith("0x") else int(tok, 10)
+    except ValueError:
+        raise AsmError("%d: sayi bekleniyordu: %r" % (line, tok))
+
+
+def byte(tok, line, lo=0):
+    v = num(tok, line)
+    if not lo <= v <= 0xFF:
+        raise AsmError("%d: byte araligi disinda: %r" % (line, tok))
+    return v
+
+
+def hexbyte(tok, line):
+    try:
+        v = int(tok, 16)
+    except ValueError:
+        raise AsmError("%d: hex byte bekleniyordu: %r" % (line, tok))
+    if not 0 <= v <= 0xFF:
+        raise AsmError("%d: byte araligi disinda: %r" % (line, tok))
+    return v
+
+
+def load_queries(path):
+    """queryBitEnum degerlerini header'dan oku (sirali, 0'dan)."""
+    names = {}
+    try:
+        text = open(path).read()
+    except OSError:
+        return {"NONE": 0}
+    m = re.search(r"typedef\s+enum\s*\{(.*?)\}\s*queryBitEnum", text, re.S)
+    if not m:
+        return {"NONE": 0}
+    body = re.sub(r"/\*.*?\*/|//[^\n]*", "", m.group(1), flags=re.S)
+    value = 0
+    for item in body.split(","):
+        item = item.strip()
+        if not item:
+            continue
+        name, _, init = item.partition("=")
+        name = name.strip()
+        if init.strip():
+            value = int(init.strip().rstrip("Uu"), 0)
+        names[name[len("QUERY_"):] if name.startswith("QUERY_") else name] = value
+        value += 1
+    return names
+
+
+def split_repeat(toks, line):
+    """Sondaki 'xN' tekrar belirtecini ayir."""
+    if toks and re.fullmatch(r"[xX]\d+", toks[-1]):
+        n = int(toks[-1][1:])
+        if not 1 <= n <= 0xFF:
+            raise AsmError("%d: tekrar 1..255 olmali" % line)
+        return toks[:-1], n
+    return toks, 1
+
+
+def assemble_step(toks, line):
+    """Bir adim -> (bytes, payload boyu, gereken kontrol boyu)."""
+    op = toks[0].lower()
+    args, n = split_repeat(toks[1:], line)
+    if op == "const":
+        if len(args) != 1:
+            raise AsmError("%d: const V [xN]" % line)
+        return bytes([PAYACT_CONST, n, byte(args[0], line)]), n, 0
+    if op == "copy":
+        if len(args) != 1:
+            raise AsmError("%d: copy OFF [xN]" % line)
+        off = byte(args[0], line)
+        return bytes([PAYACT_COPY, off, n]), n, off + n + TR_CTRL_TAIL_SIZE
+    if op == "scale8":
+        if len(args) != 3:
+            raise AsmError("%d: scale8 OFF MUL DIV [xN]" % line)
+        off, mul, div = (byte(a, line) for a in args)
+        if div == 0:
+            raise AsmError("%d: scale8 DIV sifir olamaz" % line)
+        return bytes([PAYACT_SCALE8, off, mul, div, n]), n, off + 1 + TR_CTRL_TAIL_SIZE
+    if op == "lookup":
+        text = " ".join(args)
+        m = re.fullmatch(r"(\S+)\s*\[(.*)\]", text)
+        if not m:
+            raise AsmError("%d: lookup OFF [t0 t1 ...] [xN]" % line)
+        off = byte(m.group(1), line)
+        table = [byte(t, line) for t in m.group(2).replace(",", " ").split()]
+        if not 1 <= len(table) <= 0xFF:
+            raise AsmError("%d: lookup tablosu 1..255 eleman" % line)
+        return (bytes([PAYACT_LOOKUP, off, n, len(table)]) + bytes(table),
+                n, off + 1 + TR_CTRL_TAIL_SIZE)
+    raise AsmError("%d: bilinmeyen adim %r" % (line, toks[0]))
+
+
+def parse(path, queries):
+    cmds = []
+    cur = None
+    for line, raw in enumerate(open(path), 1):
+        text = raw.split("#", 1)[0].strip()
+        if not text:
+            continue
+        toks = shlex.split(text)
+        if toks[0] == "cmd":
+            if cur is not None:
+                raise AsmError("%d: onceki cmd 'end' ile kapanmadi" % line)
+            if len(toks) not in (11, 12):
+                raise AsmError("%d: cmd KB0:KB1 TIP ESLESME QUERY YANIT SINIF BIRLESTIR B1 B2 B3 [\"aciklama\"]" % line)
+            kb = toks[1].split(":")
+            if len(kb) != 2:
+                raise AsmError("%d: anahtar KB0:KB1 olmali" % line)
+            if toks[2].upper() not in TYPES:
+                raise AsmError("%d: tip SET ya da READ" % line)
+            match = toks[3].upper()
+            if match == "ANY":
+                kind, value = 0, 0
+            elif match.startswith("P0="):
+                kind, value = 1, hexbyte(match[3:], line)
+            else:
+                raise AsmError("%d: eslesme ANY ya da P0=xx" % line)
+            q = toks[4].upper()
+            q = q[len("QUERY_"):] if q.startswith("QUERY_") else q
+            if q in queries:
+                query = queries[q]
+            else:
+                query = num(q, line)
+            if toks[5].upper() not in RESPS:
+                raise AsmError("%d: yanit ACK, ECHO ya da MULTI" % line)
+            if toks[6].upper() not in PRIOS:
+                raise AsmError("%d: sinif INTERACTIVE, TRIGGER, READ ya da POLL" % line)
+            if toks[7].upper() not in FLAGS:
+                raise AsmError("%d: birlestirme COALESCE ya da -" % line)
+            if FLAGS[toks[7].upper()] and toks[2].upper() != "SET":
+                raise AsmError("%d: COALESCE sadece SET komutunda" % line)
+            cur = {
+                "line": line,
+                "kb": (hexbyte(kb[0], line), hexbyte(kb[1], line)),
+                "type": TYPES[toks[2].upper()],
+                "kind": kind,
+                "value": value,
+                "query": query,
+                "resp": RESPS[toks[5].upper()],
+                "prio": PRIOS[toks[6].upper()],
+                "flags": FLAGS[toks[7].upper()],
+                "cam": tuple(hexbyte(t, line) for t in toks[8:11]),
+                "desc": toks[11] if len(toks) == 12 else "",
+                "code": b"",
+                "steps": [],
+                "payload": 0,
+                "min_ctrl": CTRL_PKT_MIN_SIZE,
+            }
+        elif toks[0] == "end":
+            if cur is None:
+                raise AsmError("%d: cmd olmadan end" % line)
+            cur["code"] += bytes([PAYACT_END])
+            cmds.append(cur)
+            cur = None
+        else:
+            if cur is None:
+                raise AsmError("%d: adim cmd blogu disinda" % line)
+            code, n, need = assemble_step(toks, line)
+            cur["code"] += code
+            cur["steps"].append(code)
+            cur["payload"] += n
+            cur["min_ctrl"] = max(cur["min_ctrl"], need)
+            if cur["payload"] > CAM_PAYLOAD_MAX:
+                raise AsmError("%d: kamera payload'u %d byte'i asiyor" % (line, CAM_PAYLOAD_MAX))
+            if cur["min_ctrl"] > 0xFF:
+                raise AsmError("%d: kontrol ofseti paket boyunu asiyor" % line)
+    if cur is not None:
+        raise AsmError("dosya sonu: cmd 'end' ile kapanmadi")
+    return cmds
+
+
+def order_of(c):
+    key = (c["kb"][0] << 8) | c["kb"][1]
+    return (key << 16) | (c["type"] << 9) | (c["value"] if c["kind"] else 256)
+
+
+def build(cmds, queries):
+    if len(cmds) > CMDTAB_MAX_ENTRIES:
+        raise AsmError("en fazla %d komut" % CMDTAB_MAX_ENTRIES)
+    seen = {}
+    for c in cmds:
+        o = order_of(c)
+        if o in seen:
+            raise AsmError("%d: ayni anahtar/tip/eslesme satir %d'de de var" % (c["line"], seen[o]))
+        seen[o] = c["line"]
+        if not 0 <= c["query"] < queries.get("MAX", max(queries.values()) + 1):
+            raise AsmError("%d: query %d queryBitEnum disinda" % (c["line"], c["query"]))
+
+    # Ayni govdeli komutlar kodu paylasir
+    code = b""
+    offsets = {}
+    for c in cmds:
+        if c["code"] not in offsets:
+            offsets[c["code"]] = len(code)
+            code += c["code"]
+        c["off"] = offsets[c["code"]]
+
+    entries = b""
+    for c in cmds:
+        entries += struct.pack("<BBBBBBB3BBBH", c["kb"][0], c["kb"][1], c["type"], c["kind"],
+                               c["value"], c["query"], c["resp"], *c["cam"], c["prio"],
+                               c["flags"], c["off"])
+    body = entries + code
+    header = struct.pack("<IHHHHI", CMDTAB_MAGIC, CMDTAB_VERSION, len(cmds), len(code), 0,
+                         zlib.crc32(body) & 0xFFFFFFFF)
+    image = header + body
+    if len(image) > CMDTAB_REGION:
+        raise AsmError("imaj %d byte, CMDTAB bolgesi %d byte" % (len(image), CMDTAB_REGION))
+    return image
+
+
+def intel_hex(image, base):
+    def rec(kind, addr, data):
+        raw = bytes([len(data), (addr >> 8) & 0xFF, addr & 0xFF, kind]) + data
+        return ":%s%02X" % (raw.hex().upper(), (-sum(raw)) & 0xFF)
+
+    out = [rec(4, 0, struct.pack(">H", base >> 16))]
+    for i in range(0, len(image), 16):
+        out.append(rec(0, (base + i) & 0xFFFF, image[i:i + 16]))
+    out.append(rec(1, 0, b""))
+    return "\n".join(out) + "\n"
+
+
+def listing(cmds, image):
+    prio_names = dict((v, k) for k, v in PRIOS.items())
+    rows = ["%-9s %-4s %-6s %-8s  %-11s %-8s %5s %4s %4s  %s" %
+            ("key", "tip", "match", "cam", "sinif", "birles", "kod", "pl", "min", "aciklama")]
+    for c in sorted(cmds, key=order_of):
+        rows.append("%02X:%02X     %-4s %-6s %02X %02X %02X  %-11s %-8s %5d %4d %4d  %s" % (
+            c["kb"][0], c["kb"][1], "SET" if c["type"] == 0 else "READ",
+            "P0=%02X" % c["value"] if c["kind"] else "ANY", *c["cam"],
+            prio_names[c["prio"]], "COALESCE" if c["flags"] & CMDTAB_FLAG_COALESCE else "-",
+            len(c["code"]), c["payload"], c["min_ctrl"], c["desc"]))
+    rows.append("imaj: %d / %d byte" % (len(image), CMDTAB_REGION))
+    return "\n".join(rows)
+
+
+def expand_steps(steps):
+    """Adim bytecode'lari -> kamera payload'unun byte basina tanimi.
+    Ayni ciktiyi veren farkli yazimlar (const 0 x3 + const 0 ile
+    TrConst<0,4>) esit sayilir."""
+    out = []
+    for c in steps:
+        op = c[0]
+        if op == PAYACT_CONST:
+            out += [("const", c[2])] * c[1]
+        elif op == PAYACT_COPY:
+            out += [("copy", c[1] + k) for k in range(c[2])]
+        elif op == PAYACT_SCALE8:
+            out += [("scale8", c[1], c[2], c[3])] * c[4]
+        elif op == PAYACT_LOOKUP:
+            out += [("lookup", c[1], tuple(c[4:]))] * c[2]
+    return out
+
+
+def split_top(text, sep=","):
+    """Parantez/<>/{} disindaki ayiricilarla bol."""
+    parts, depth, cur, quote = [], 0, "", False
+    for ch in text:
+        if ch == '"':
+            quote = not quote
+        elif not quote and ch in "<({":
+            depth += 1
+        elif not quote and ch in ">)}":
+            depth -= 1
+        if ch == sep and depth == 0 and not quote:
+            parts.append(cur.strip())
+            cur = ""
+        else:
+            cur += ch
+    if cur.strip():
+        parts.append(cur.strip())
+    return parts
+
+
+def cpp_int(tok):
+    return int(tok.strip().rstrip("Uu"), 0)
+
+
+def translator_steps(text, src):
+    """&TrCamCmd<B1,B2,B3, adimlar...>::translate -> (cam, adim bytecode'lari)."""
+    m = re.fullmatch(r"&?\s*TrCamCmd\s*<(.*)>\s*::\s*translate", text, re.S)
+    if not m:
+        return None
+    args = split_top(m.group(1))
+    cam = tuple(cpp_int(a) for a in args[:3])
+    steps = []
+    for a in args[3:]:
+        sm = re.fullmatch(r"(\w+)\s*<(.*)>", a, re.S)
+        if not sm:
+            return None
+        name, p = sm.group(1), split_top(sm.group(2))
+        if name == "TrConst":
+            n = cpp_int(p[1]) if len(p) > 1 else 1
+            steps.append(bytes([PAYACT_CONST, n, cpp_int(p[0])]))
+        elif name == "TrCopy":
+            n = cpp_int(p[1]) if len(p) > 1 else 1
+            steps.append(bytes([PAYACT_COPY, cpp_int(p[0]), n]))
+        elif name == "TrScale8":
+            n = cpp_int(p[3]) if len(p) > 3 else 1
+            steps.append(bytes([PAYACT_SCALE8, cpp_int(p[0]), cpp_int(p[1]), cpp_int(p[2]), n]))
+        elif name == "TrLookup":
+            tm = re.search(r"\b%s\s*\[[^]]*\]\s*=\s*\{([^}]*)\}" % re.escape(p[1].strip()), src)
+            if not tm:
+                return None
+            table = [cpp_int(t) for t in tm.group(1).split(",") if t.strip()]
+            n = cpp_int(p[3]) if len(p) > 3 else 1
+            steps.append(bytes([PAYACT_LOOKUP, cpp_int(p[0]), n, len(table)]) + bytes(table))
+        else:
+            return None
+    return cam, steps
+
+
+def load_command_map(path, queries):
+    """command_handler.cpp'deki command_map[] satirlarini oku."""
+    src = open(path).read()
+    m = re.search(r"command_map\[\]\s*=\s*\{(.*?)\n\};", src, re.S)
+    if not m:
+        raise AsmError("%s: command_map bulunamadi" % path)
+    body = re.sub(r"/\*.*?\*/|//[^\n]*", "", m.group(1), flags=re.S)
+    rows = []
+    for item in split_top(body):
+        f = split_top(item.strip()[1:-1])
+        if len(f) != 9:
+            raise AsmError("%s: command_map satiri 9 alan olmali: %s" % (path, item.strip()))
+        km = re.fullmatch(r"MAKE_CTRL_KEY\((.*),(.*)\)", f[0].replace(" ", ""))
+        q = f[1][len("QUERY_"):]
+        row = {
+            "kb": (cpp_int(km.group(1)), cpp_int(km.group(2))),
+            "type": TYPES[f[2][len("CMD_TYPE_"):]],
+            "query": queries.get(q),
+            "cam": tuple(cpp_int(t) for t in f[3].strip("{} ").split(",")),
+            "translator": None if f[4] == "NULL" else translator_steps(f[4], src),
+            "has_translator": f[4] != "NULL",
+            "resp": RESP_GENS.get(f[5]),
+            "desc": f[6].strip('"'),
+            "frames": f[7] != "NULL",
+            "prio": PRIOS.get(f[8][len("CMD_PRIO_"):]),
+        }
+        # PrepareCtrlView: translator'lu SET birlesir, tek frame'li eylem birlesmez
+        row["coalesce"] = CMDTAB_FLAG_COALESCE if (row["type"] == 0 and not row["frames"]) else 0
+        rows.append(row)
+    return rows
+
+
+def check(cmds, rows):
+    """Tablo komutlarini golgeledikleri command_map kayitlariyla karsilastir."""
+    errors = []
+    report = []
+    for c in sorted(cmds, key=order_of):
+        name = "%d: %02X:%02X %s" % (c["line"], c["kb"][0], c["kb"][1], "SET" if c["type"] == 0 else "READ")
+        row = next((r for r in rows if r["kb"] == c["kb"] and r["type"] == c["type"]), None)
+        if row is None:
+            report.append("%s yeni komut" % name)
+            continue
+        if row["frames"] or not row["has_translator"]:
+            errors.append("%s: command_map '%s' hazir frame kumesi kullaniyor, bytecode ile dogrulanamaz"
+                          % (name, row["desc"]))
+            continue
+        if row["translator"] is None:
+            errors.append("%s: command_map '%s' translator'u cozulemedi" % (name, row["desc"]))
+            continue
+        cam, steps = row["translator"]
+        diffs = []
+        if c["cam"] != row["cam"] or c["cam"] != cam:
+            diffs.append("kamera komutu")
+        if c["query"] != row["query"]:
+            diffs.append("query")
+        if c["resp"] != row["resp"]:
+            diffs.append("yanit")
+        if c["prio"] != row["prio"]:
+            diffs.append("sinif")
+        if c["flags"] != row["coalesce"]:
+            diffs.append("birlestirme")
+        if expand_steps(c["steps"]) != expand_steps(steps):
+            diffs.append("payload adimlari")
+        if diffs:
+            errors.append("%s: command_map '%s' ile farkli: %s" % (name, row["desc"], ", ".join(diffs)))
+        else:
+            report.append("%s = command_map '%s'" % (name, row["desc"]))
+    return report, errors
+
+
+def main():
+    ap = argparse.ArgumentParser(description="Flash komut tablosu assembler'i")
+    ap.add_argument("source")
+    ap.add_argument("-o", "--output", help="ham imaj (.bin)")
+    ap.add_argument("--hex", help="Intel HEX, CMDTAB adresinde")
+    ap.add_argument("--base", type=lambda s: int(s, 0), default=CMDTAB_BASE)
+    ap.add_argument("--tracking-h", default=TRACKING_H, help="queryBitEnum kaynagi")
+    ap.add_argument("--list", action="store_true", help="komut listesini yazdir")
+    ap.add_argument("--check", action="store_true", help="command_map ile karsilastir")
+    ap.add_argument("--map-src", default=HANDLER_CPP, help="command_map kaynagi")
+    args = ap.parse_args()
+    if not args.output and not args.check:
+        ap.error("-o ya da --check gerekli")
+
+    queries = load_queries(args.tracking_h)
+    try:
+        cmds = parse(args.source, queries)
+        image = build(cmds, queries)
+        if args.check:
+            report, errors = check(cmds, load_command_map(args.map_src, queries))
+            for r in report:
+                print(r)
+            if errors:
+                raise AsmError("command_map ile uyumsuz:\n  " + "\n  ".join(errors))
+    except AsmError as e:
+        sys.stderr.write("%s: %s\n" % (args.source, e))
+        return 1
+
+    if not args.output:
+        return 0
+    with open(args.output, "wb") as f:
+        f.write(image)
+    if args.hex:
+        with open(args.hex, "w") as f:
+            f.write(intel_hex(image, args.base))
+    if args.list:
+        print(listing(cmds, image))
+    return 0
+
+
+if __name__ == "__main__":
+    sys.exit(main())
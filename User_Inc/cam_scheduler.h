@@ -0,0 +1,152 @@
+/**
+ * @file cam_scheduler.h
+ * @brief Kamera tarafi gonderim penceresi (kredi tabanli akis kontrolu)
+ *
+ * Cevrilmis kamera komutlari kameraya hemen verilmez: ayni anda yanit
+ * bekleyen (yolda) komut sayisi pencere boyunu (1..CAM_SCHED_WINDOW_MAX)
+ * gecemez. Kamera icin kredi = pencere - yoldaki komut; kredi yoksa komut
+ * (frame + bekleyen komut kaydi) sirada bekler. Yanit gelince ya da komut
+ * timeout olunca kredi geri doner ve CamSched_Process siradakini gonderir.
+ *
+ *   kontrol frame -> CommandHandler_PrepareCtrlView -> CamSched_Submit
+ *                    -> (kredi) UART_SendToCamera* + CommandHandler_CommitSent
+ *
+ * Hazir (flash) frame'ler kopyalanmaz, uretilenler siraya kopyalanir.
+ *
+ * Oncelik siniflari: her komut CommandMapping_t kaydindaki sinifla
+ * (cmdPriority_t: interaktif set > tetik > okuma > arka plan sorgu) kendi
+ * sinifinin sirasina girer; sinif icinde gelis sirasi korunur. Kredi
+ * acilinca siradaki sinif politikaya gore secilir:
+ *   - CAM_SCHED_POLICY_STRICT:   her zaman en yuksek dolu sinif
+ *   - CAM_SCHED_POLICY_WEIGHTED: sinif basina tur hakki 8:4:2:1
+ * Aclik korumasi: bas elemani CAM_SCHED_STARVE_MS'den uzun bekleyen sinif,
+ * politikadan bagimsiz olarak one alinir. Sinif basina siradaki bekleme
+ * suresi (CamSched_GetClassStats) interaktif gecikme kazancini olcer.
+ *
+ * Birlestirme (son yazan kazanir): operator parlaklik / kontrast / zoom
+ * tusunu basili tuttugunda ayni parametre icin art arda set gelir. Sirada
+ * henuz gonderilmemis ayni parametreli (ayni query_id ve kamera komutu
+ * B1 B2 B3) bir set varsa yenisi onun yerine gecer; eskisi kameraya hic
+ * gitmez ama kontrol tarafi ACK'ini hemen alir
+ * (CommandHandler_RespondSuperseded). Tek frame'li eylem komutlari
+ * (Manuel NUC) ve flash tablosunda COALESCE bayragi olmayan setler
+ * birlestirilmez.
+ *
+ * Tek ucus okuma: ayni sorgunun (queryBitEnum) okumasi yoldaysa ya da
+ * sirada bekliyorsa yeni okuma ona bekleyen olarak eklenir, kameraya
+ * ayrica gitmez; tek yanit her bekleyene kopyalanir. Ayni parametreye bir
+ * set gonderildikten ya da siraya girdikten sonra onceki okumalara ekleme
+ * yapilmaz (set'ten onceki degeri dondururler); sirada set varken gelen
+ * okuma set'in sinifina girer ve ondan sonra gider.
+ *
+ * Pencere boyu basina sayaclar tutulur; CamSched_GetThroughput ile ayni
+ * yuk altinda farkli pencere boylari karsilastirilabilir.
+ */
+#ifndef CAM_SCHEDULER_H_
+#define CAM_SCHEDULER_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "command_tracking.h"
+
+/* En buyuk pencere (bekleyen komut buffer'i ve TX kuyrugu ile sinirli) */
+#define CAM_SCHED_WINDOW_MAX        (8U)
+
+/* Acilistaki pencere boyu */
+#ifndef CAM_SCHED_WINDOW_DEFAULT
+#define CAM_SCHED_WINDOW_DEFAULT    (4U)
+#endif
+
+/* Kredi bekleyen komut sirasi, tum siniflar toplam (2'nin kuvveti) */
+#ifndef CAM_SCHED_QUEUE_DEPTH
+#define CAM_SCHED_QUEUE_DEPTH       (16U)
+#endif
+
+/* Alt sinifin one alinmasi icin bas elemanin en uzun beklemesi */
+#ifndef CAM_SCHED_STARVE_MS
+#define CAM_SCHED_STARVE_MS         (250U)
+#endif
+
+/* Sinif secim politikasi */
+typedef enum {
+    CAM_SCHED_POLICY_STRICT = 0U,   /* kesin oncelik */
+    CAM_SCHED_POLICY_WEIGHTED       /* agirlikli tur (8:4:2:1) */
+} CamSchedPolicy_t;
+
+/* Acilistaki politika */
+#ifndef CAM_SCHED_POLICY_DEFAULT
+#define CAM_SCHED_POLICY_DEFAULT    CAM_SCHED_POLICY_STRICT
+#endif
+
+/* Genel sayaclar */
+typedef struct {
+    uint32_t submitted;     /* CamSched_Submit'e gelen komut */
+    uint32_t deferred;      /* kredi yoktu, sirada bekletildi */
+    uint32_t dropped;       /* sira dolu, atildi */
+    uint32_t coalesced;     /* yerine yenisi gecen set: kazanilan kamera islemi */
+    uint32_t read_waiters;  /* yoldaki / siradaki ayni okumaya eklenen: kazanilan kamera islemi */
+    uint8_t queue_peak;     /* en fazla bekleyen */
+    uint8_t in_flight_peak; /* en fazla yoldaki */
+} CamSchedStats_t;
+
+/* Pencere boyu basina sayaclar (o boy etkinken biriken) */
+typedef struct {
+    uint32_t sent;          /* kameraya verilen */
+    uint32_t responses;     /* yanitla kapanan */
+    uint32_t timeouts;      /* timeout ile kapanan */
+    uint32_t busy_ms;       /* sirada ya da yolda komut varken gecen sure */
+} CamSchedWindowStats_t;
+
+/* Oncelik sinifi basina sayaclar. Ortalama gecikme = delay_sum_ms / sent;
+   beklemeden giden komut 0 ms sayilir */
+typedef struct {
+    uint32_t sent;          /* kameraya verilen */
+    uint32_t delay_sum_ms;  /* siradaki toplam bekleme */
+    uint32_t delay_max_ms;  /* en uzun bekleme */
+    uint32_t promoted;      /* aclik korumasiyla ust sinifin onune gecen */
+} CamSchedClassStats_t;
+
+/* Baslatma: pencere CAM_SCHED_WINDOW_DEFAULT, politika
+   CAM_SCHED_POLICY_DEFAULT, sira bos, sayaclar sifir */
+void CamSched_Init(void);
+
+/* Pencere boyunu degistir (1..CAM_SCHED_WINDOW_MAX). Kuculurse fazla
+   yoldaki komutlar kapanana kadar yeni komut gonderilmez */
+bool CamSched_SetWindow(uint8_t window);
+uint8_t CamSched_GetWindow(void);
+
+/* Su an gonderilebilecek komut sayisi */
+uint8_t CamSched_GetCredits(void);
+
+/* Sirada bekleyen komut sayisi (tum siniflar / tek sinif) */
+uint8_t CamSched_GetQueued(void);
+uint8_t CamSched_GetQueuedClass(cmdPriority_t cls);
+
+/* Sinif secim politikasini degistir; sirada bekleyenler korunur */
+bool CamSched_SetPolicy(CamSchedPolicy_t policy);
+CamSchedPolicy_t CamSched_GetPolicy(void);
+
+/* Cevrilmis komutu kameraya ver ya da siraya koy.
+   frame_static: frame flash'ta (kopyalanmaz). req_ptr gonderimde bekleyen
+   komut listesine eklenir. false = sira dolu, komut atildi */
+bool CamSched_Submit(const uint8_t *frame, uint8_t len, bool frame_static, const cmdBlock_t *req_ptr);
+
+/* Ana donguden (UART_Handler_Process) cagrilir: kredi oldukca siradakini gonderir */
+void CamSched_Process(void);
+
+/* Bekleyen bir komut yanitla kapandi (UART_HandleCameraFrame) */
+void CamSched_OnResponse(void);
+
+/* count komut timeout ile kapandi (CommandHandler_CheckTimeouts sonucu) */
+void CamSched_OnTimeouts(uint8_t count);
+
+void CamSched_GetStats(CamSchedStats_t *out);
+void CamSched_GetWindowStats(uint8_t window, CamSchedWindowStats_t *out);
+void CamSched_GetClassStats(cmdPriority_t cls, CamSchedClassStats_t *out);
+
+/* window boyundayken mesgul saniye basina kapanan yanit, 0 = olcum yok */
+uint32_t CamSched_GetThroughput(uint8_t window);
+
+void CamSched_ResetStats(void);
+
+#endif /* CAM_SCHEDULER_H_ */
@@ -0,0 +1,77 @@
+/**
+ * @file checksum.h
+ * @brief Kontrol (byte toplami) ve kamera (XOR) checksum cekirdekleri
+ *
+ * Byte byte dongu yerine kelime (word) bazli calisir:
+ *   - Cortex-M4 (DSP): toplam __USADA8 ile komut basina 4 byte,
+ *     XOR 32 bit kelimelerle katlanir
+ *   - Host, SSE2: _mm_sad_epu8 / _mm_xor_si128 ile 16 byte
+ *   - Host, NEON: vpadalq_u8 / veorq_u8 ile 16 byte
+ *   - Diger: SWAR (maskeli 16 bit seritler) / 32 bit XOR katlama
+ * Hizalama gerekmez; bas/son kalan bytelar tek tek islenir.
+ *
+ * Framer bu fonksiyonlari kullanmaz: checksum byte geldikce artimli
+ * hesaplanir (uart_handler.cpp). Cekirdekler tamamlanmis tamponlar icindir
+ * (Verify*Packet, yanit ureticileri).
+ */
+
+#ifndef CHECKSUM_H_
+#define CHECKSUM_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/* Derlenen cekirdek (Checksum_KernelName ile de okunabilir) */
+#define CHECKSUM_KERNEL_GENERIC   (0U)
+#define CHECKSUM_KERNEL_DSP       (1U)
+#define CHECKSUM_KERNEL_SSE2      (2U)
+#define CHECKSUM_KERNEL_NEON      (3U)
+
+#if defined(__ARM_FEATURE_DSP) && (__ARM_FEATURE_DSP == 1)
+#define CHECKSUM_KERNEL           CHECKSUM_KERNEL_DSP
+#elif defined(__SSE2__)
+#define CHECKSUM_KERNEL           CHECKSUM_KERNEL_SSE2
+#elif defined(__ARM_NEON)
+#define CHECKSUM_KERNEL           CHECKSUM_KERNEL_NEON
+#else
+#define CHECKSUM_KERNEL           CHECKSUM_KERNEL_GENERIC
+#endif
+
+/**
+ * @brief len byte'in toplami (mod 256) - CalculateCtrlChecksum cekirdegi
+ */
+uint8_t Checksum_Sum8(const uint8_t *data_ptr, uint32_t len);
+
+/**
+ * @brief len byte'in XOR'u - CalculateCamChecksum cekirdegi
+ */
+uint8_t Checksum_Xor8(const uint8_t *data_ptr, uint32_t len);
+
+const char *Checksum_KernelName(void);
+
+/**
+ * @brief Cekirdek / byte dongusu karsilastirmasi (CHECKSUM_CYCLE_STATS == 1)
+ *
+ * Ortalama cevrim (DWT), ayni len byte'lik tampon uzerinde.
+ */
+typedef struct {
+    uint16_t len;
+    uint32_t sum_loop_cycles;     /* eski byte byte toplam */
+    uint32_t sum_kernel_cycles;   /* Checksum_Sum8 */
+    uint32_t xor_loop_cycles;     /* eski byte byte XOR */
+    uint32_t xor_kernel_cycles;   /* Checksum_Xor8 */
+    bool results_match;           /* cekirdek sonuclari dongulerle ayni */
+} ChecksumBench_t;
+
+/**
+ * @brief Her len icin dongu ve cekirdegi iterations kez calistir
+ *        (sadece CHECKSUM_CYCLE_STATS == 1 ile derlenir)
+ *
+ * @param[out] out    lens_count satir
+ * @param[in]  lens   olculecek uzunluklar (en fazla 256)
+ *
+ * @return out'a yazilan satir sayisi
+ */
+uint8_t Checksum_Benchmark(ChecksumBench_t *out, const uint16_t *lens, uint8_t lens_count, uint16_t iterations);
+
+#endif /* CHECKSUM_H_ */
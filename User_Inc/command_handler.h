@@ -24,6 +24,7 @@
 #include <stdbool.h>
 #include "command_tracking.h"
 #include "packet_builder.h"
+#include "packet_view.h"
 
 /* Make 16-bit key from KB0,KB1 */
 #define MAKE_CTRL_KEY(kb0,kb1) ( (uint16_t)( ((uint16_t)(kb0) << 8U) | (uint16_t)(kb1) ) )
@@ -39,6 +40,8 @@
 #define CTRL_PKT_RESERVE_READ   (0x00U)  /* Read komutlarinda reserve byte */
 #define CTRL_PKT_RESP_RESERVE	(0x33U)  /* Response'larda reserve byte */
 #define CTRL_PKT_RESP_ACK_BYTE  (0x01U)  /* Set response ACK byte */
+#define CTRL_PKT_LEN_OVERHEAD   (4U)     /* Toplam boy = LEN + 4 (START, LEN, EB, AA) */
+#define CTRL_PKT_MIN_SIZE       (8U)     /* En kisa paket: read komutu */
 
 /* Kamera tarafi protokol sabitleri */
 #define CAM_PKT_START1          (0x55U)  /* Baslangic byte 1 */
@@ -46,9 +49,18 @@
 #define CAM_PKT_END             (0xF0U)  /* Bitis byte */
 #define CAM_PKT_ACK_OK          (0x00U)  /* Basarili response */
 #define CAM_PKT_ACK_ERROR       (0x01U)  /* Hata response */
+#define CAM_PKT_LEN_OVERHEAD    (5U)     /* Toplam boy = LEN + 5 (55, AA, LEN, XOR, F0) */
 
 
 #define COMMAND_TIMEOUT_MS      (1000U)
+
+/* Ceviri memo cache'i: kayit sayisi ve saklanabilen en uzun kontrol frame'i
+   (CONTROL_RX_BUFFER_SIZE). Daha uzun frame'ler cache'e girmez. */
+#ifndef CMD_MEMO_ENTRIES
+#define CMD_MEMO_ENTRIES        (8U)
+#endif
+#define CMD_MEMO_CTRL_MAX       (32U)
+
 /**
  * @brief Komut tipi
  */
@@ -73,11 +85,10 @@ typedef enum {
 /**
  * @brief Kontrol -> Kamera ceviri fonksiyonu
  *
- * Kontrol tarafindan gelen paketi kamera formatina cevirir
+ * Kontrol tarafindan gelen (dogrulanmis) paketi kamera formatina cevirir
  */
 typedef bool (*CtrlToCamTranslator_t)(
-    const uint8_t *ctrl_packet_ptr,
-    uint8_t ctrl_len,
+    const CtrlPacketView_t *ctrl_view_ptr,
     uint8_t *cam_packet_ptr,
     uint8_t *cam_len_ptr
 );
@@ -85,30 +96,51 @@ typedef bool (*CtrlToCamTranslator_t)(
 /**
  * @brief Kamera -> Kontrol yanit uretici fonksiyon
  *
- * Kamera yanitindan kontrol yaniti olusturur
+ * Kamera yanitindan kontrol yaniti olusturur. Orjinal istegin gereken
+ * alanlari bekleyen komut blogundan (pending_ptr) okunur.
  */
 typedef bool (*CamToCtrlResponse_t)(
-    const uint8_t *cam_response_ptr,
-    uint8_t cam_len,
-    const uint8_t *original_ctrl_req_ptr,
-    uint8_t original_ctrl_len,
+    const CamPacketView_t *cam_view_ptr,
+    const cmdBlock_t *pending_ptr,
     uint8_t *ctrl_response_ptr,
     uint8_t *ctrl_resp_len_ptr
 );
 /**
- * @brief Opsiyonel matcher: payload bazli daha ince eslesme
+ * @brief Flash komut tablosu (CMDTAB) kayitlarinin payload eslesmesi
  *
- * Return true means mapping matches this ctrl packet (e.g. payload range).
+ * Ayni ctrl_key + tip'i paylasan tablo kayitlari ilk payload byte'i
+ * (packet[5]) ile ayrilir. command_map kayitlari sadece anahtar + tip ile
+ * secilir.
  */
-typedef bool (*CtrlMatchFunc_t)(
-    const uint8_t *ctrl_packet_ptr,
-    uint8_t ctrl_len
-);
+typedef enum {
+    CMD_MATCH_ANY = 0U,   /* payload'a bakilmaz (grubun varsayilani) */
+    CMD_MATCH_P0          /* packet[5] == value */
+} CtrlMatchKind_t;
+
+/**
+ * @brief Onceden hazirlanmis kamera frame kumesi (flash)
+ *
+ * Kontrol paketinin key_off ofsetindeki key_len byte, keys[] (artan) icinde
+ * ikili aramayla bulunur; ayni siradaki frame checksum'i hesaplanmis tam
+ * kamera paketidir ve kopyalanmadan gonderilir. key_len 0 ise tek frame vardir.
+ * Tablolar translator_dsl.h'deki TrFrameTable ile derleme aninda uretilir.
+ */
+typedef struct {
+    uint8_t key_off;          /* secici bytelarin kontrol paketindeki ofseti */
+    uint8_t key_len;
+    uint8_t count;
+    uint8_t frame_len;        /* tum frame'ler ayni boyda */
+    const uint8_t *keys;      /* count * key_len byte */
+    const uint8_t *frames;    /* count * frame_len byte */
+} CamFrameSet_t;
 
 /**
  * @brief Komut eslestirme kaydi
  *
- * Bu struct flash'ta saklanir. matcher NULL ise translator tek basina yeterlidir.
+ * Bu struct flash'ta saklanir. Kayit anahtar + tip ile secilir.
+ * frames dolu ise kamera paketi hazir frame kumesinden secilir; translator
+ * (NULL olabilir) sadece kumede olmayan payload icin kullanilir. prio, kamera komutunun gonderim sirasindaki
+ * sinifidir (cam_scheduler).
  */
 typedef struct CommandMapping_s {
     uint16_t ctrl_key;                 /* control-side command byte (packet[3]) */
@@ -117,22 +149,68 @@ typedef struct CommandMapping_s {
     uint8_t cam_cmd[3];               /* camera command bytes suggestion */
     CtrlToCamTranslator_t translator; /* ceviri fonksiyonu */
     CamToCtrlResponse_t response_gen; /* yanit uretici */
-    CtrlMatchFunc_t matcher;          /* opsiyonel: payload'a gore eslesme */
     const char *desc;                 /* aciklama (readonly) */
+    const CamFrameSet_t *frames;      /* sonlu payload kumesi: hazir frame'ler */
+    cmdPriority_t prio;               /* gonderim sirasi sinifi */
 }CommandMapping_t;
 
-/* Direct lookup: 256 pointers (small RAM cost, fast lookup) */
-extern const CommandMapping_t *g_cmd_lookup_table[256];
+/**
+ * @brief KB0/KB1 anahtarina ait ilk mapping'i bulur (O(1))
+ *
+ * Derleme aninda uretilen iki seviyeli tablo (flash) kullanilir; acilista
+ * kurulum gerekmez. Ayni anahtari paylasan kayitlar command_map[] icinde
+ * ardisiktir, donen pointer grubun ilk kaydidir.
+ *
+ * @return Mapping pointer, anahtar tanimli degilse NULL
+ */
+const CommandMapping_t *FindMappingByCtrlKey(uint16_t key);
 
 /**
- * @brief Build lookup table from static mapping array.
+ * @brief Kontrol paketine uyan mapping'i secer
  *
- * Call once at init (CommandHandler_Init does this).
+ * Anahtar grubunda reserve byte (01 SET / 00 READ) ile tipin kaydi secilir;
+ * her anahtar + tip icin en fazla bir kayit vardir.
+ *
+ * @return Mapping pointer, uyan kayit yoksa NULL
  */
-void CommandHandler_BuildLookup(void);
+const CommandMapping_t *FindMappingForCtrlPacket(const CtrlPacketView_t *ctrl_view_ptr);
+
+/**
+ * @brief Ceviri memo cache sayaclari (boyutlandirma icin)
+ */
+typedef struct {
+    uint32_t hits;          /* ayni frame tekrar: ceviri atlandi */
+    uint32_t misses;        /* dogrulanmis frame cache'te yoktu */
+    uint32_t evictions;     /* dolu cache'te en eski kayit cikarildi */
+} CmdMemoStats_t;
+
+/**
+ * @brief Kamera yaniti eslestirme sayaclari, cmdMatchKind_t ile indekslenir
+ *
+ * count[CMD_MATCH_FIFO] artiyorsa yanitlar belirsizdir (NACK ya da beklenen
+ * sekilde komut yok); count[CMD_MATCH_NONE] bekleyen komutu olmayan yanittir.
+ */
+typedef struct {
+    uint32_t count[CMD_MATCH_COUNT];
+} CmdMatchStats_t;
+
+/**
+ * @brief Komut basina ceviri maliyeti (CMD_TRANSLATE_CYCLE_STATS == 1)
+ *
+ * Ortalama cevrim (DWT), kamera paketinin tamamini uretmek icin. 0 = bu
+ * yolda komut yok (native: command_map, bytecode: flash tablosu).
+ */
+typedef struct {
+    uint32_t order;             /* ctrl_key << 16 | tip << 9 | P0 (ANY = 256) */
+    uint32_t native_cycles;
+    uint32_t bytecode_cycles;
+} CmdTranslateCost_t;
 
 /**
  * @brief Komut isleyiciyi baslat
+ *
+ * Bekleyen komut buffer'ini sifirlar ve flash komut tablosunu
+ * (commands_metadata.h) dogrulayip yukler.
  */
 void CommandHandler_Init(void);
 
@@ -140,10 +218,14 @@ void CommandHandler_Init(void);
  * CommandHandler_TranslateCtrlToCam - Kontrol paketini kamera paketine cevirir
  *
  * Bu fonksiyon:
- *  - Kontrol paketini dogrular (VerifyCtrlPacket),
- *  - KB0/KB1 anahtarini olusturup command_map uzerinde binary search ile mapping bulur,
- *  - Eger mapping->matcher varsa onu calistirir,
- *  - Mapping'in translator'ini cagirarak kamera paketini uretir,
+ *  - Kontrol paketini dogrular ve gorunumunu kurar (CtrlPacketView_Parse),
+ *  - Ayni frame memo cache'te varsa bitmis kamera frame'ini oradan alir
+ *    (arama / eslesme / ceviri atlanir),
+ *  - Once flash komut tablosuna (CmdTab_FindForCtrlPacket), yoksa KB0/KB1
+ *    anahtari, reserve byte ve payload ile derleme aninda uretilen karar
+ *    tablosuna (FindMappingForCtrlPacket) bakar,
+ *  - Bytecode yorumlayicisi ya da mapping'in translator'i ile kamera
+ *    paketini uretir,
  *  - Orjinal kontrol istegini pending buffer'a (CmdRingBuffer) ekler.
  *
  *
@@ -155,6 +237,79 @@ TranslationResult_t CommandHandler_TranslateCtrlToCam(
     uint8_t *cam_len_ptr
 );
 
+/**
+ * @brief Her komutun ceviri maliyetini native ve bytecode yolda olc
+ *        (sadece CMD_TRANSLATE_CYCLE_STATS == 1 ile derlenir)
+ *
+ * command_map ve yuklu tablo komutlari icin sentetik bir kontrol paketi
+ * (anahtar, reserve, P0; payload sifir) ile translator iterations kez
+ * cagrilir. Ayni anahtar/tip/eslesme iki yolda da varsa ayni satirda
+ * karsilastirilir. Bekleyen komut listesine dokunmaz.
+ *
+ * @return out'a yazilan satir sayisi
+ */
+uint8_t CommandHandler_ProfileTranslators(CmdTranslateCost_t *out, uint8_t max_rows, uint16_t iterations);
+
+/**
+ * @brief Cozumlenmis kontrol frame'ini kamera paketine cevir, hazir frame
+ *        varsa kopyalamadan
+ *
+ * CommandHandler_TranslateCtrlToCam ile ayni isi yapar; frame tekrar
+ * dogrulanmaz, sadece ctrl_view_ptr->checksum_ok'a bakilir. Fark cikistadir:
+ * komut hazir frame kumesinden geliyorsa *cam_frame_ptr flash'taki frame'i
+ * gosterir (scratch'e yazilmaz), aksi halde scratch_ptr'ye uretilir ve
+ * *cam_frame_ptr == scratch_ptr olur. scratch en az TR_CAM_PKT_MAX byte.
+ */
+TranslationResult_t CommandHandler_TranslateCtrlView(
+    const CtrlPacketView_t *ctrl_view_ptr,
+    uint8_t *scratch_ptr,
+    const uint8_t **cam_frame_ptr,
+    uint8_t *cam_len_ptr
+);
+
+/**
+ * @brief Ceviriyi yap, bekleyen komut kaydini eklemeden req_ptr'ye hazirla
+ *
+ * CommandHandler_TranslateCtrlView'in ilk yarisi. Kamera komutu gonderim
+ * penceresinde bekleyecekse (cam_scheduler) kayit frame ile birlikte
+ * saklanir ve frame kameraya verildiginde CommandHandler_CommitSent ile
+ * eklenir.
+ */
+TranslationResult_t CommandHandler_PrepareCtrlView(
+    const CtrlPacketView_t *ctrl_view_ptr,
+    uint8_t *scratch_ptr,
+    const uint8_t **cam_frame_ptr,
+    uint8_t *cam_len_ptr,
+    cmdBlock_t *req_ptr
+);
+
+/**
+ * @brief Kameraya verilen komutu bekleyen komut listesine ekle
+ *        (timeout bu andan sayilir)
+ *
+ * @return false = bekleyen komut listesi dolu
+ */
+bool CommandHandler_CommitSent(const cmdBlock_t *req_ptr);
+
+/**
+ * @brief Ayni sorgu yoldaysa okumayi ona bekleyen olarak ekle (tek ucus)
+ *
+ * Eklenen okuma kameraya gonderilmez; yoldaki okumanin yaniti geldiginde
+ * ProcessCamResponseView bu okuma icin de bir kopya ister (*copies_ptr).
+ * Timeout olursa bekleyenler de yanitsiz kalir (eski davranisla ayni).
+ *
+ * @return true = eklendi, false = okuma degil / sorgu yolda degil
+ */
+bool CommandHandler_AttachReadWaiter(const cmdBlock_t *req_ptr);
+
+/**
+ * @brief Sirada bekleyen set icin yoldaki ayni parametre okumalarini kapat
+ *
+ * Set kameraya gittiginde CommitSent bunu zaten yapar; set sirada beklerken
+ * gelen okuma yoldaki eski okumaya eklenmesin diye siraya girerken cagrilir.
+ */
+void CommandHandler_CloseReads(const cmdBlock_t *set_req_ptr);
+
 /**
  * @brief Kamera yanitini kontrol yanitina cevir
  *
@@ -172,6 +327,40 @@ TranslationResult_t CommandHandler_ProcessCamResponse(
     uint8_t *ctrl_len_ptr
 );
 
+/**
+ * @brief Cozumlenmis kamera yanitini kontrol yanitina cevir, sabit yanitta
+ *        kopyalamadan
+ *
+ * CommandHandler_ProcessCamResponse ile ayni; frame tekrar dogrulanmaz.
+ * Yanit en eski komuta degil, CmdRingBuffer_Match ile kendi istegine eslenir
+ * (echo edilen kamera komutu, yanit sekli; belirsizse en eski komut).
+ * Set ACK'i gibi sabit yanitlarda *ctrl_frame_ptr flash'taki hazir frame'i
+ * gosterir, diger yanitlar scratch_ptr'ye uretilir (*ctrl_frame_ptr == scratch_ptr).
+ * *copies_ptr (NULL olabilir): yanitin kontrole kac kez gonderilecegi; tek
+ * ucus okumasina eklenen bekleyenler kadar 1'den fazladir.
+ */
+TranslationResult_t CommandHandler_ProcessCamResponseView(
+    const CamPacketView_t *cam_view_ptr,
+    uint8_t *scratch_ptr,
+    const uint8_t **ctrl_frame_ptr,
+    uint8_t *ctrl_len_ptr,
+    uint16_t *copies_ptr
+);
+
+/**
+ * @brief Sirada yerine yenisi gecen (birlestirilen) set istegine kontrol yaniti
+ *
+ * Istek kameraya hic gitmez; yanit, kamera ortak ACK'i donmus gibi istegin
+ * mapping'indeki yanit ureticisi ile uretilir. Cikis ProcessCamResponseView
+ * ile aynidir (sabit ACK flash'tan, digerleri scratch_ptr'ye).
+ */
+TranslationResult_t CommandHandler_RespondSuperseded(
+    const cmdBlock_t *req_ptr,
+    uint8_t *scratch_ptr,
+    const uint8_t **ctrl_frame_ptr,
+    uint8_t *ctrl_len_ptr
+);
+
 /**
  * @brief Timeout kontrol et
  *
@@ -179,6 +368,18 @@ TranslationResult_t CommandHandler_ProcessCamResponse(
  */
 uint8_t CommandHandler_CheckTimeouts(void);
 
+/**
+ * @brief Memo cache sayaclarini oku / sifirla
+ */
+void CommandHandler_GetMemoStats(CmdMemoStats_t *out);
+void CommandHandler_ResetMemoStats(void);
+
+/**
+ * @brief Yanit eslestirme sayaclarini oku / sifirla
+ */
+void CommandHandler_GetMatchStats(CmdMatchStats_t *out);
+void CommandHandler_ResetMatchStats(void);
+
 /**
  * @brief Bekleyen komut sayisi
  *
@@ -226,6 +427,26 @@ bool VerifyCtrlPacket(const uint8_t *packet_ptr, uint8_t len);
  */
 bool VerifyCamPacket(const uint8_t *packet_ptr, uint8_t len);
 
+/**
+ * @brief Frame gorunumunu kur (dogrulama yapmaz)
+ *
+ * Framer trailer ve checksum'i zaten kontrol ettiyse checksum_ok = true ile
+ * cagrilir. Boy protokol sinirlari disindaysa checksum_ok false'a cekilir ve
+ * alanlar okunmaz.
+ */
+void CtrlPacketView_Init(CtrlPacketView_t *view_ptr, const uint8_t *packet_ptr, uint16_t len, bool checksum_ok);
+void CamPacketView_Init(CamPacketView_t *view_ptr, const uint8_t *packet_ptr, uint16_t len, bool checksum_ok);
+
+/**
+ * @brief Frame'i dogrula (Verify*Packet) ve gorunumunu kur
+ *
+ * Framer'dan gecmemis bytelar icin (eski API'ler, testler).
+ *
+ * @return view_ptr->checksum_ok
+ */
+bool CtrlPacketView_Parse(CtrlPacketView_t *view_ptr, const uint8_t *packet_ptr, uint16_t len);
+bool CamPacketView_Parse(CamPacketView_t *view_ptr, const uint8_t *packet_ptr, uint16_t len);
+
 #endif /* COMMAND_HANDLER_H */
 
 /* command_handler.h sonu */
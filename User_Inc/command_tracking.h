@@ -2,6 +2,19 @@
  * @file commands_tracking.h
  * @brief Bekleyen komutlari takip eden circular buffer
  *
+ * Kayitlar sabit bir slot dizisinde tutulur ve indeks listeleri ile
+ * baglanir (pointer / heap yok, her islem O(1)):
+ *   - yas listesi: gonderilme sirasi (Front/Drop/Pop/timeout, FIFO yedegi)
+ *   - yanit sekli listeleri: ACK bekleyen (set) / veri bekleyen (read)
+ *   - echo kovalari: veri bekleyen kayitlar, kamera komutu (B1 B2 B3) ile
+ * Kamera yaniti CmdRingBuffer_Match ile kendi istegine eslenir; boylece
+ * kaybolan ya da timeout olan bir yanit sonraki yanitlari kaydirmaz.
+ *
+ * Tek ucus (single-flight) okuma: yolda olan sorgular (queryBitEnum) bir
+ * bit maskesinde tutulur. Ayni sorgu yoldayken gelen okuma kameraya
+ * gitmez, yoldaki kayda bekleyen (waiter) olarak eklenir; tek kamera
+ * yaniti her bekleyen icin bir kontrol yaniti uretir.
+ *
  * @author oguz00
  * @date 2025-11-17
  * @version 1.0
@@ -13,6 +26,7 @@
 #include <stdint.h>
 #include <stdbool.h>
 #include <string.h>
+#include "packet_view.h"
 
 // command_handler.h ile circular dependency engellemek için
 struct CommandMapping_s;
@@ -22,7 +36,16 @@ struct CommandMapping_s;
 /** @brief Maksimum komut paket uzunlugu */
 #define CMD_MAX_LENGTH (32U)
 /** @brief Buffer'da tutulabilecek maksimum komut sayisi */
+#ifndef CMD_BUFFER_SIZE
 #define CMD_BUFFER_SIZE   (16U)
+#endif
+/** @brief Echo indeksindeki kova sayisi (2'nin kuvveti) */
+#define CMD_ECHO_BUCKETS  (16U)
+/** @brief Bos liste / slot yok */
+#define CMD_SLOT_NONE     (0xFFU)
+/** @brief Bir okumaya eklenebilecek en fazla bekleyen; yanit 1 + bekleyen
+ *         kopya olarak kontrol TX kuyruguna (UART_TX_QUEUE_DEPTH) sigmali */
+#define CMD_READ_WAITERS_MAX  (7U)
 //Tip tanımları->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
 /**
  * @brief Sorgu tipi enum
@@ -37,6 +60,43 @@ typedef enum {
     QUERY_MAX                     /**< Maksimum deger */
 } queryBitEnum;
 
+/**
+ * @brief Komutun bekledigi kamera yaniti sekli
+ *
+ * Set komutlarina kamera sadece durum byte'i ile doner (55 AA 01 STATUS XOR F0),
+ * read komutlarina durum + veri ile.
+ */
+typedef enum {
+    CMD_RESP_SHAPE_ACK = 0U,      /**< Sadece STATUS (set) */
+    CMD_RESP_SHAPE_DATA,          /**< STATUS + veri (read) */
+    CMD_RESP_SHAPE_COUNT
+} cmdRespShape_t;
+
+/**
+ * @brief Kamera gonderim sirasindaki oncelik sinifi (kucuk = once)
+ *
+ * CommandMapping_t kaydi (ya da flash tablosu kaydi) basina atanir;
+ * cam_scheduler her sinifi ayri sirada tutar.
+ */
+typedef enum {
+    CMD_PRIO_INTERACTIVE = 0U,    /**< Operator set'i (zoom, palet) */
+    CMD_PRIO_TRIGGER,             /**< Tetik / eylem (Manuel NUC, shutter) */
+    CMD_PRIO_READ,                /**< Kontrolun istedigi okuma */
+    CMD_PRIO_POLL,                /**< Arka plan durum sorgusu */
+    CMD_PRIO_COUNT
+} cmdPriority_t;
+
+/**
+ * @brief Yanitin bekleyen komuta nasil eslendigi
+ */
+typedef enum {
+    CMD_MATCH_NONE = 0U,          /**< Bekleyen komut yok */
+    CMD_MATCH_ECHO,               /**< Yanittaki komut bytelari (B1 B2 B3) */
+    CMD_MATCH_SHAPE,              /**< Yanit sekli: en eski ayni sekilli komut */
+    CMD_MATCH_FIFO,               /**< Belirsiz (NACK / sekil yok): en eski komut */
+    CMD_MATCH_COUNT
+} cmdMatchKind_t;
+
 /**
  * @brief Komut blogu yapisi
  *
@@ -46,25 +106,59 @@ typedef enum {
 typedef struct{
 //	uint8_t expected_response[CMD_MAX_LENGTH]; 		/**< Beklenen yanit paketi */
 //	uint32_t response_length; 						/**< Yanit uzunlugu */
-	uint8_t original_request[CMD_MAX_LENGTH];		/**< Orjinal istek paketi */
+	/* Orjinal istegin tamami saklanmaz; yanit ureticinin kullandigi alanlar tutulur */
+	uint8_t ctrl_cmd;								/**< Istek komut byte'i (packet[3]) */
+	uint16_t ctrl_key;								/**< Istek anahtari KB0/KB1 (MAKE_CTRL_KEY) */
+	uint8_t ctrl_param;								/**< Ilk payload byte'i (packet[5]) */
 	uint32_t request_lenth;							/**< Istek uzunlugu */
 	queryBitEnum nmbr;								/**< Sorgu tipi */
 	uint32_t timestamp;								/**< Gonderilme zamani (ms) */
 	const void *mapping;							/**< CommandMapping_t pointer */
+	uint8_t cam_cmd[3];								/**< Gonderilen kamera komutu B1 B2 B3 */
+	uint8_t shape;									/**< Beklenen yanit sekli (cmdRespShape_t) */
+	uint8_t coalesce;								/**< 1 = sirada ayni parametreye yeni set gelirse yerine gecebilir */
+	uint8_t waiters;								/**< Bu okumaya eklenen ayni sorgular (ek yanit sayisi) */
+	uint8_t prio;									/**< Gonderim sirasi sinifi (cmdPriority_t) */
+	uint8_t joinable;								/**< 1 = ayni sorgunun yeni okumasi bu kayda eklenebilir */
 
 } cmdBlock_t ;
 #pragma pack(pop)
+/** @brief Slot listeleri: her slot her listede en fazla bir kez bulunur */
+typedef enum {
+    CMD_LIST_AGE = 0U,            /**< Gonderilme sirasi (bos slotlarda serbest liste) */
+    CMD_LIST_SHAPE,               /**< cmdRespShape_t basina */
+    CMD_LIST_ECHO,                /**< Echo kovasi basina (sadece veri bekleyenler) */
+    CMD_LIST_COUNT
+} cmdListKind_t;
+
+/** @brief Liste basi/sonu (slot indeksi, CMD_SLOT_NONE = bos) */
+typedef struct {
+    uint8_t head;
+    uint8_t tail;
+} cmdList_t;
+
+/** @brief Slotun listelerdeki komsulari */
+typedef struct {
+    uint8_t prev[CMD_LIST_COUNT];
+    uint8_t next[CMD_LIST_COUNT];
+} cmdLink_t;
+
 /**
  * @brief Circular buffer yapisi
  *
- * Bekleyen komutlari yoneten ring buffer
+ * Bekleyen komutlari yoneten slot tablosu. Ad eski API ile uyum icin
+ * korunmustur; sira bilgisi head/tail yerine yas listesindedir.
  */
 #pragma pack(push, 1)
 typedef struct{
-	cmdBlock_t buffer[CMD_MAX_LENGTH]; /**< Komut blokları dizisi */
-	uint32_t head;					   /**< Yazma pozisyonu*/
-	uint32_t tail;						/**< Okuma pozisyonu*/
-	uint32_t count;						/**< Buffer'daki eleman sayisi*/
+	cmdBlock_t buffer[CMD_BUFFER_SIZE];			/**< Komut blokları dizisi */
+	cmdLink_t link[CMD_BUFFER_SIZE];			/**< Slot komsulari */
+	cmdList_t age;								/**< En eski -> en yeni */
+	cmdList_t shape[CMD_RESP_SHAPE_COUNT];		/**< Yanit sekline gore */
+	cmdList_t echo[CMD_ECHO_BUCKETS];			/**< Kamera komutuna gore */
+	uint8_t free_head;							/**< Bos slotlar (age.next ile bagli) */
+	uint32_t query_mask;						/**< Yoldaki okuma sorgulari, bit = queryBitEnum */
+	uint32_t count;								/**< Buffer'daki eleman sayisi*/
 }cmdRingBuffer_t;
 #pragma pack(pop)
 //Fonksiyon prototipleri ->>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>>
@@ -83,28 +177,137 @@ void CmdRingBuffer_Init(cmdRingBuffer_t* ring_buf_ptr);
  * @brief Buffer'a yeni komut ekle
  *
  * Bekleyen komut listesine yeni bir komut ekler.
- * Orjinal istek, beklenen yanit ve metadata saklanir.
+ * Orjinal istek kopyalanmaz; yanit uretimi icin gereken alanlar
+ * (komut byte'i, ilk payload byte'i, uzunluk) cozumlenmis frame
+ * gorunumunden alinir ve metadata saklanir.
  *
  * @param[in,out] ring_buf_ptr       Buffer pointer (NULL olmamali)
- * @param[in]     expected_resp_ptr  Beklenen yanit (NULL olabilir)
- * @param[in]     resp_len           Yanit uzunlugu
- * @param[in]     orig_req_ptr       Orjinal istek paketi (NULL olmamali)
- * @param[in]     req_len            Istek uzunlugu
+ * @param[in]     req_view_ptr       Dogrulanmis istek gorunumu (NULL olmamali)
  * @param[in]     query_type         Sorgu tipi
  * @param[in]     mapping_ptr        Komut mapping pointer (NULL olmamali)
+ * @param[in]     cam_cmd_ptr        Kameraya giden B1 B2 B3 (NULL olmamali)
+ * @param[in]     shape              Beklenen yanit sekli
  *
  * @return true = basarili, false = buffer dolu veya gecersiz parametre
  */
 
 bool CmdRingBuffer_PushComplete(
 		cmdRingBuffer_t *ring_buf_ptr,
-//		const uint8_t *expected_resp_ptr,
-//		uint32_t resp_len,
-		const uint8_t *org_req_ptr,
-		uint32_t req_len,
+		const CtrlPacketView_t *req_view_ptr,
 		queryBitEnum query_type,
-		const void *mapping_ptr
+		const void *mapping_ptr,
+		const uint8_t *cam_cmd_ptr,
+		cmdRespShape_t shape
 		);
+
+/**
+ * @brief Istekten komut blogunu hazirla (buffer'a eklemeden)
+ *
+ * Komut kameraya hemen gitmeyecekse (gonderim penceresi dolu) blok hazirlanip
+ * saklanir, gonderildigi anda CmdRingBuffer_PushBlock ile eklenir; timeout
+ * suresi gonderimden itibaren sayilir. Parametreler PushComplete ile aynidir.
+ *
+ * @return true = hazirlandi, false = gecersiz parametre / uzunluk
+ */
+bool CmdRingBuffer_MakeBlock(
+		cmdBlock_t *block_ptr,
+		const CtrlPacketView_t *req_view_ptr,
+		queryBitEnum query_type,
+		const void *mapping_ptr,
+		const uint8_t *cam_cmd_ptr,
+		cmdRespShape_t shape
+		);
+
+/**
+ * @brief Hazirlanmis blogu ekle, zaman damgasini simdi olarak yaz
+ *
+ * @return true = basarili, false = buffer dolu veya gecersiz parametre
+ */
+bool CmdRingBuffer_PushBlock(
+		cmdRingBuffer_t *ring_buf_ptr,
+		const cmdBlock_t *req_block_ptr
+		);
+
+/**
+ * @brief Kamera yanitini bekleyen komutuna esle (kuyruktan kaldirmaz)
+ *
+ * Sira:
+ *   1. Veri yaniti, durum byte'indan sonra B1 B2 B3'u tekrarliyorsa echo
+ *      kovasindaki en eski ayni komut
+ *   2. Durumu 00 olan ACK yaniti -> en eski set, veri yaniti -> en eski read
+ *   3. Belirsiz (NACK her komuta gelebilir, o sekilde bekleyen yok) -> en eski
+ * Maliyet kova zincirinin boyu ile sinirlidir, kuyruk derinligine bagli degildir.
+ *
+ * @param[in]  ring_buf_ptr  Buffer pointer
+ * @param[in]  resp_view_ptr Dogrulanmis kamera yaniti
+ * @param[out] kind_ptr      Eslesme sekli (NULL olabilir)
+ *
+ * @return Eslenen komut blogu (Remove'a kadar gecerli), bekleyen yoksa NULL
+ */
+const cmdBlock_t *CmdRingBuffer_Match(
+    const cmdRingBuffer_t *ring_buf_ptr,
+    const CamPacketView_t *resp_view_ptr,
+    cmdMatchKind_t *kind_ptr
+);
+
+/**
+ * @brief Ayni sorgu yoldaysa okumayi ona bekleyen olarak ekle
+ *
+ * Maske bakisi O(1); bit set ise kayit veri bekleyen listesinde aranir.
+ *
+ * @param[in,out] ring_buf_ptr  Buffer pointer
+ * @param[in]     query_type    Okumanin sorgusu (QUERY_NONE eklenmez)
+ *
+ * @return true = eklendi (kameraya gonderilmemeli), false = yolda degil / sayac dolu
+ */
+bool CmdRingBuffer_AttachWaiter(
+    cmdRingBuffer_t *ring_buf_ptr,
+    queryBitEnum query_type
+);
+
+/**
+ * @brief Sorgu yolda mi (bit maskesi)
+ */
+bool CmdRingBuffer_IsQueryInFlight(
+    const cmdRingBuffer_t *ring_buf_ptr,
+    queryBitEnum query_type
+);
+
+/**
+ * @brief Iki komut ayni parametreye mi ait (ayni kontrol anahtari KB0/KB1
+ *        ya da ayni kamera komutu B1 B2 B3)
+ */
+bool CmdBlock_SameParam(const cmdBlock_t *a_ptr, const cmdBlock_t *b_ptr);
+
+/**
+ * @brief Set'ten once gonderilmis ayni parametre okumalarini kapat
+ *
+ * Bu okumalar set'ten onceki degeri dondurur; sonra gelen okuma onlara
+ * eklenmemeli (yazmadan sonra okuma). Kayitlar yolda kalir, sadece
+ * joinable sifirlanir ve sorgu biti baska eklenebilir kayit yoksa temizlenir.
+ * PushBlock set eklerken kendisi cagirir; set sirada beklerken de
+ * cagrilmalidir.
+ *
+ * @param[in,out] ring_buf_ptr  Buffer pointer
+ * @param[in]     set_block_ptr Gonderilen / siraya giren set
+ */
+void CmdRingBuffer_CloseReads(
+    cmdRingBuffer_t *ring_buf_ptr,
+    const cmdBlock_t *set_block_ptr
+);
+
+/**
+ * @brief Verilen komutu (sirasi ne olursa olsun) kaldir
+ *
+ * @param[in,out] ring_buf_ptr  Buffer pointer (NULL olmamali)
+ * @param[in]     block_ptr     Front/Match'in dondurdugu blok
+ *
+ * @return true = kaldirildi, false = blok bu buffer'da bekleyen bir komut degil
+ */
+bool CmdRingBuffer_Remove(
+    cmdRingBuffer_t *ring_buf_ptr,
+    const cmdBlock_t *block_ptr
+);
 /**
  * @brief En eski komutu al ve bu komutu kuyruktan kaldir
  *
@@ -136,6 +339,31 @@ bool CmdRingBuffer_Peek(
     cmdBlock_t *block_ptr
 );
 
+/**
+ * @brief En eski komuta kopyalamadan eris
+ *
+ * Pop/Peek'in aksine blogu kopyalamaz, buffer icindeki yerine isaret eder.
+ * Pointer, bir sonraki Drop/Push/Clear cagrisina kadar gecerlidir.
+ *
+ * @param[in] ring_buf_ptr  Buffer pointer
+ *
+ * @return En eski komut blogu, buffer bossa NULL
+ */
+const cmdBlock_t *CmdRingBuffer_Front(
+    const cmdRingBuffer_t *ring_buf_ptr
+);
+
+/**
+ * @brief En eski komutu kopyalamadan kaldir
+ *
+ * @param[in,out] ring_buf_ptr  Buffer pointer (NULL olmamali)
+ *
+ * @return true = kaldirildi, false = buffer bos veya gecersiz parametre
+ */
+bool CmdRingBuffer_Drop(
+    cmdRingBuffer_t *ring_buf_ptr
+);
+
 /**
  * @brief Buffer bos mu kontrol et
  *
@@ -163,7 +391,7 @@ bool CmdRingBuffer_IsFull(
  *
  * @param[in] ring_buf_ptr  Buffer pointer
  *
- * @return Bekleyen komut sayisi (0-16 arasi)
+ * @return Bekleyen komut sayisi (0-CMD_BUFFER_SIZE arasi)
  */
 uint32_t CmdRingBuffer_Size(
     const cmdRingBuffer_t *ring_buf_ptr
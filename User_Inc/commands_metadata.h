@@ -0,0 +1,151 @@
+/**
+ * @file commands_metadata.h
+ * @brief Flash'ta tutulan, sahada guncellenebilir komut tablosu (bytecode)
+ *
+ * command_map[] disinda kalan / yeniden ayarlanan kamera komutlari, firmware
+ * derlenmeden ayri bir flash sayfasina (linker: CMDTAB, _scmd_table) yazilan
+ * bir tablo imajindan calistirilir. Imaj Tools/cmdtab_asm.py ile uretilir.
+ *
+ * Imaj yerlesimi (little endian):
+ *   CmdTabHeader_t
+ *   CmdTabEntry_t  x entry_count
+ *   bytecode       code_size byte
+ *
+ * Bytecode (eski payload_step_t adimlarinin kodlanmis hali, operandlar opcode'u
+ * izler):
+ *   PAYACT_END                                 -> trailer (XOR F0)
+ *   PAYACT_CONST   n  v                        -> v, n kez
+ *   PAYACT_COPY    off n                       -> ctrl[off .. off+n-1]
+ *   PAYACT_SCALE8  off mul div n               -> ctrl[off]*mul/div (255'te doyar), n kez
+ *   PAYACT_LOOKUP  off n len t0..t(len-1)      -> t[ctrl[off]], n kez (indeks >= len ise red)
+ *
+ * Tablo acilista bir kez dogrulanir (CRC, opcode/operand araliklari, cikti boyu,
+ * kontrol paketi icin gereken en kisa boy) ve RAM'de sirali bir indeks kurulur.
+ * Yorumlayici bu yuzden adim basina sinir kontrolu yapmaz; tek kontrol paket
+ * boyunun komutun min_ctrl degerine yetip yetmedigidir.
+ *
+ * Tablo kaydi, ayni anahtar/tip/eslesmedeki command_map kaydindan once aranir.
+ * Gonderim sinifi (prio) ve sirada birlestirme (CMDTAB_FLAG_COALESCE) kaydin
+ * kendisindedir; bayraksiz set (Manuel NUC gibi eylem) birlestirilmez.
+ */
+
+#ifndef COMMANDS_METADATA_H_
+#define COMMANDS_METADATA_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include "command_handler.h"
+
+#define CMDTAB_MAGIC            (0x54444D43UL)  /* "CMDT" */
+#define CMDTAB_VERSION          (2U)
+#define CMDTAB_MAX_ENTRIES      (32U)           /* RAM indeksi boyu */
+
+/* CmdTabEntry_t.flags */
+#define CMDTAB_FLAG_COALESCE    (0x01U)         /* sirada ayni parametreye yeni set gelirse yerine gecebilir */
+
+/* Komut kodu: opcode degerleri imaj formatinin parcasidir, degistirmeyin */
+typedef enum {
+    PAYACT_END = 0U,
+    PAYACT_CONST,
+    PAYACT_COPY,
+    PAYACT_SCALE8,
+    PAYACT_LOOKUP,
+    PAYACT_COUNT
+} payload_action_t;
+
+/* Yanit uretici secimi (command_handler.cpp'deki ResponseGen_* fonksiyonlari) */
+typedef enum {
+    CMDTAB_RESP_ACK = 0U,
+    CMDTAB_RESP_ECHO,
+    CMDTAB_RESP_MULTI,
+    CMDTAB_RESP_COUNT
+} CmdTabResp_t;
+
+typedef enum {
+    CMDTAB_OK = 0U,
+    CMDTAB_EMPTY,           /* sayfa silinmis (0xFF) - sadece command_map */
+    CMDTAB_BAD_HEADER,      /* magic / versiyon / boy */
+    CMDTAB_BAD_CRC,
+    CMDTAB_BAD_ENTRY,       /* tip, eslesme, query, yanit, sinif, bayrak alani gecersiz */
+    CMDTAB_BAD_CODE,        /* opcode, operand, cikti boyu */
+    CMDTAB_DUPLICATE        /* ayni anahtar + tip + eslesme iki kez */
+} CmdTabStatus_t;
+
+/* Imaj basligi, 16 byte. crc32: basliktan sonraki entry + code alani (IEEE, zlib ile ayni) */
+typedef struct {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t entry_count;
+    uint16_t code_size;
+    uint16_t reserved;
+    uint32_t crc32;
+} CmdTabHeader_t;
+
+/* Imajdaki komut kaydi, 14 byte */
+typedef struct {
+    uint8_t kb0;
+    uint8_t kb1;
+    uint8_t type;           /* CommandType_t */
+    uint8_t match_kind;     /* CtrlMatchKind_t */
+    uint8_t match_value;    /* CMD_MATCH_P0 icin packet[5] */
+    uint8_t query_id;       /* queryBitEnum */
+    uint8_t resp;           /* CmdTabResp_t */
+    uint8_t cam_cmd[3];     /* B1 B2 B3 */
+    uint8_t prio;           /* cmdPriority_t: gonderim sirasi sinifi */
+    uint8_t flags;          /* CMDTAB_FLAG_*; COALESCE sadece SET'te */
+    uint16_t code_off;      /* bytecode alanina gore ofset */
+} CmdTabEntry_t;
+
+/* Yuklemede cozulmus komut (RAM indeksi, order'a gore sirali) */
+typedef struct {
+    uint32_t order;         /* ctrl_key << 16 | tip << 9 | P0 (ANY = 256) */
+    const uint8_t *code;    /* flash'taki ilk opcode */
+    uint8_t cam_cmd[3];
+    uint8_t len_field;      /* kamera LEN = 3 + payload */
+    uint8_t head_xor;       /* LEN, B1..B3 ve sabit bytelarin XOR'u */
+    uint8_t min_ctrl;       /* gereken en kisa kontrol paketi */
+    uint8_t query_id;
+    uint8_t resp;
+    uint8_t prio;           /* cmdPriority_t */
+    uint8_t coalesce;       /* 1 = CMDTAB_FLAG_COALESCE */
+} CmdTabCommand_t;
+
+/**
+ * @brief Tablo imajini dogrula ve indeksle
+ *
+ * Hata durumunda tablo tamamen devre disi kalir (kismi yukleme yok).
+ *
+ * @param[in] image        Imaj baslangici
+ * @param[in] region_size  Imaj icin ayrilan alan (byte)
+ */
+CmdTabStatus_t CmdTab_Load(const uint8_t *image, uint32_t region_size);
+
+/**
+ * @brief Linker'in ayirdigi CMDTAB flash sayfasindaki tabloyu yukle
+ */
+CmdTabStatus_t CmdTab_LoadFromFlash(void);
+
+CmdTabStatus_t CmdTab_GetStatus(void);
+uint8_t CmdTab_GetCount(void);
+const CmdTabCommand_t *CmdTab_GetCommand(uint8_t index);
+
+/**
+ * @brief Kontrol paketine uyan tablo komutunu bul
+ *
+ * Anahtar + reserve byte command_map'teki gibi secilir; ayni anahtar + tip
+ * icinde ilk payload byte'i ile CMD_MATCH_P0, yoksa CMD_MATCH_ANY kaydi doner.
+ *
+ * @return Komut, tabloda yoksa NULL
+ */
+const CmdTabCommand_t *CmdTab_FindForCtrlPacket(const CtrlPacketView_t *ctrl_view_ptr);
+
+/**
+ * @brief Tablo komutunu yorumlayarak kamera paketini uret
+ *
+ * CtrlToCamTranslator_t ile ayni sozlesme; cikti en fazla TR_CAM_PKT_MAX byte.
+ */
+bool CmdTab_Translate(const CmdTabCommand_t *cmd,
+                      const CtrlPacketView_t *ctrl_view_ptr,
+                      uint8_t *cam_packet_ptr, uint8_t *cam_len_ptr);
+
+#endif /* COMMANDS_METADATA_H_ */
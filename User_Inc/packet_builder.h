@@ -1,17 +1,25 @@
 /**
  * @file packet_builder.h
- * @brief Dynamic packet generator for old and new camera protocol formats
+ * @brief Header-only packet builder for old (control) and new (camera) formats
  *
  * This module provides packet building and parsing functions for both
  * old control format and new camera format protocols. It handles:
- * - Automatic checksum calculation for old format
+ * - Automatic checksum calculation (sum for old, XOR for new format)
  * - Automatic length field updates
  * - Buffer overflow protection
  * - Type-safe parameter addition
  *
+ * Every function is constexpr: the same API builds a dynamic packet at
+ * runtime and a fixed frame at compile time. Fixed frames are declared
+ * constexpr (flash, no RAM copy) and guarded with static_assert, e.g.
+ * @code
+ * constexpr NewPacket_t ack = NewPacket_Make(0x00U);
+ * static_assert(NewPacket_IsValid(&ack), "ack");
+ * @endcode
+ *
  * @author oguz00
  * @date 2025-11-17
- * @version 1.0
+ * @version 2.0
  *
  * @par MISRA-C:2012 Compliance:
  * This file complies with MISRA-C:2012 guidelines:
@@ -21,13 +29,16 @@
  *
  * @par Old Format Structure:
  * @code
- * [START] [LENGTH] [RESERVED] [CMD_ID] [DATA...] [CS_HIGH] [CS_LOW] [END]
+ * [START] [LENGTH] [0x00] [CMD_ID] [DATA...] [CS] [0xEB] [0xAA]
  * @endcode
+ * LENGTH = total - 4, CS = sum of all bytes before CS (mod 256).
+ * DATA starts with the reserve byte (01 set / 00 read / 33 response).
  *
  * @par New Format Structure:
  * @code
- * [0x55] [0xAA] [LENGTH] [TYPE] [DATA...] [0xF0]
+ * [0x55] [0xAA] [LENGTH] [TYPE] [DATA...] [XOR] [0xF0]
  * @endcode
+ * LENGTH = total - 5, XOR over LENGTH .. last DATA byte.
  */
 
 #ifndef PACKET_BUILDER_H
@@ -39,7 +50,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
-#include <string.h>
+#include <stddef.h>
 
 /*============================================================================*/
 /* Constants and Macros                                                       */
@@ -51,6 +62,16 @@
  */
 #define PACKET_BUILDER_MAX_SIZE  (32U)
 
+#define OLD_PACKET_HEADER_SIZE   (4U)     /* START LENGTH 00 CMD_ID */
+#define OLD_PACKET_TAIL_SIZE     (3U)     /* CS EB AA */
+#define OLD_PACKET_END1          (0xEBU)
+#define OLD_PACKET_END2          (0xAAU)
+#define NEW_PACKET_HEADER_SIZE   (4U)     /* 55 AA LENGTH TYPE */
+#define NEW_PACKET_TAIL_SIZE     (2U)     /* XOR F0 */
+#define NEW_PACKET_START1        (0x55U)
+#define NEW_PACKET_START2        (0xAAU)
+#define NEW_PACKET_END           (0xF0U)
+
 /*============================================================================*/
 /* Type Definitions                                                           */
 /*============================================================================*/
@@ -63,8 +84,8 @@
  * @note MISRA-C Rule 8.12: Enum has complete type specification
  */
 typedef enum {
-    OLD_PACKET_TX = 0xAAU,  /**< Packet transmitted to control (response) */
-    OLD_PACKET_RX = 0x55U   /**< Packet received from control (request) */
+    OLD_PACKET_TX = 0xAAU,  /**< Transmitted by control (set/read request) */
+    OLD_PACKET_RX = 0x55U   /**< Received by control (response) */
 } OldPacketType_t;
 
 /**
@@ -78,7 +99,7 @@ typedef enum {
 typedef struct {
     uint8_t buffer[PACKET_BUILDER_MAX_SIZE]; /**< Internal packet buffer */
     uint8_t length;                          /**< Total packet length (including header/footer) */
-    uint8_t data_length;                     /**< Length of data section only (for LENGTH field) */
+    uint8_t data_length;                     /**< Length of data section only (after CMD_ID) */
 } OldPacket_t;
 
 /**
@@ -91,6 +112,40 @@ typedef struct {
     uint8_t length;                          /**< Total packet length */
 } NewPacket_t;
 
+/*============================================================================*/
+/* Checksum Helpers                                                           */
+/*============================================================================*/
+
+/**
+ * @brief Old format checksum: sum of data_len bytes (mod 256)
+ *
+ * @note Same algorithm as CalculateCtrlChecksum (bytes 0 .. CS-1)
+ */
+constexpr uint8_t OldPacket_Checksum(const uint8_t *data_ptr, uint8_t data_len)
+{
+    uint32_t sum = 0U;
+
+    for (uint8_t i = 0U; i < data_len; i++) {
+        sum += (uint32_t)data_ptr[i];
+    }
+    return (uint8_t)(sum & 0xFFU);
+}
+
+/**
+ * @brief New format checksum: XOR of data_len bytes
+ *
+ * @note Called with &packet[2] (LENGTH .. last DATA byte)
+ */
+constexpr uint8_t NewPacket_Checksum(const uint8_t *data_ptr, uint8_t data_len)
+{
+    uint8_t x = 0U;
+
+    for (uint8_t i = 0U; i < data_len; i++) {
+        x = (uint8_t)(x ^ data_ptr[i]);
+    }
+    return x;
+}
+
 /*============================================================================*/
 /* Old Format Packet Generator API                                           */
 /*============================================================================*/
@@ -105,172 +160,206 @@ typedef struct {
  * @param[in]  packet_type  Packet direction (TX or RX)
  * @param[in]  cmd_id       Command ID byte
  *
- * @return void
- *
- * @pre packet_ptr must not be NULL
  * @post packet is initialized with header: [type][0][0][cmd_id]
  *
- * @note MISRA-C Rule 8.2: Named parameters for clarity
- * @note After initialization, packet contains: [type] [0x00] [0x00] [cmd_id]
- * @warning Caller must ensure packet_ptr is valid
- *
  * @par Example:
  * @code
- * OldPacket_t pkt;
- * OldPacket_Init(&pkt, OLD_PACKET_TX, 0x10U);  // Zoom command response
+ * OldPacket_t pkt = {};
+ * OldPacket_Init(&pkt, OLD_PACKET_RX, 0x2AU);  // Zoom command response
+ * (void)OldPacket_AddByte(&pkt, 0x33U);        // response reserve byte
  * @endcode
  */
-void OldPacket_Init(
+constexpr void OldPacket_Init(
     OldPacket_t *packet_ptr,
     OldPacketType_t packet_type,
-    uint8_t cmd_id
-);
+    uint8_t cmd_id)
+{
+    if (packet_ptr != NULL) {
+        for (uint8_t i = 0U; i < PACKET_BUILDER_MAX_SIZE; i++) {
+            packet_ptr->buffer[i] = 0U;
+        }
+
+        /* Build header: [START] [LENGTH] [RESERVED] [CMD_ID] */
+        packet_ptr->buffer[0] = (uint8_t)packet_type;
+        packet_ptr->buffer[1] = 0U;                    /* Length - updated in Finalize */
+        packet_ptr->buffer[2] = 0x00U;
+        packet_ptr->buffer[3] = cmd_id;
+        packet_ptr->length = OLD_PACKET_HEADER_SIZE;
+        packet_ptr->data_length = 0U;
+    }
+}
 
 /**
  * @brief Add a single byte to the packet data section
  *
- * @param[in,out] packet_ptr  Pointer to packet builder (must not be NULL)
- * @param[in]     data_byte   Byte to add
- *
  * @return true if byte added successfully, false if buffer full or NULL pointer
  *
- * @pre packet_ptr must not be NULL
- * @pre packet must have been initialized with OldPacket_Init
- * @post If true returned, data_byte is added and length incremented
- *
- * @note MISRA-C Rule 8.7: Functions used externally have external linkage
- * @note Automatically increments data_length counter
- * @warning Reserves space for checksum (2 bytes) and end byte (1 byte)
+ * @warning Reserves space for checksum and end bytes (3 bytes)
  */
-bool OldPacket_AddByte(
+constexpr bool OldPacket_AddByte(
     OldPacket_t *packet_ptr,
-    uint8_t data_byte
-);
+    uint8_t data_byte)
+{
+    bool result = false;
+
+    if ((packet_ptr != NULL) &&
+        (packet_ptr->length < (PACKET_BUILDER_MAX_SIZE - OLD_PACKET_TAIL_SIZE))) {
+        packet_ptr->buffer[packet_ptr->length] = data_byte;
+        packet_ptr->length = (uint8_t)(packet_ptr->length + 1U);
+        packet_ptr->data_length = (uint8_t)(packet_ptr->data_length + 1U);
+        result = true;
+    }
+
+    return result;
+}
 
 /**
- * @brief Add a 16-bit unsigned integer (little-endian)
- *
- * @param[in,out] packet_ptr  Pointer to packet builder (must not be NULL)
- * @param[in]     data_u16    16-bit value to add
+ * @brief Add a 16-bit unsigned integer, stored as [LOW_BYTE][HIGH_BYTE]
  *
  * @return true if added successfully, false if insufficient space or NULL pointer
- *
- * @pre packet_ptr must not be NULL
- * @post Value stored as [LOW_BYTE][HIGH_BYTE]
- *
- * @note Value is stored as [LOW_BYTE] [HIGH_BYTE] (little-endian)
- *
- * @par Example:
- * @code
- * bool result = OldPacket_AddUint16(&pkt, 0x1234U);  // Adds: 0x34 0x12
- * if (result) {
- *     // Success
- * }
- * @endcode
  */
-bool OldPacket_AddUint16(
+constexpr bool OldPacket_AddUint16(
     OldPacket_t *packet_ptr,
-    uint16_t data_u16
-);
+    uint16_t data_u16)
+{
+    return OldPacket_AddByte(packet_ptr, (uint8_t)(data_u16 & 0xFFU)) &&
+           OldPacket_AddByte(packet_ptr, (uint8_t)((data_u16 >> 8) & 0xFFU));
+}
 
 /**
- * @brief Add a 32-bit unsigned integer (little-endian)
- *
- * @param[in,out] packet_ptr  Pointer to packet builder (must not be NULL)
- * @param[in]     data_u32    32-bit value to add
+ * @brief Add a 32-bit unsigned integer, stored as [BYTE0][BYTE1][BYTE2][BYTE3]
  *
  * @return true if added successfully, false if insufficient space or NULL pointer
- *
- * @pre packet_ptr must not be NULL
- * @post Value stored as [BYTE0][BYTE1][BYTE2][BYTE3]
- *
- * @note Value is stored as [BYTE0] [BYTE1] [BYTE2] [BYTE3] (little-endian)
  */
-bool OldPacket_AddUint32(
+constexpr bool OldPacket_AddUint32(
     OldPacket_t *packet_ptr,
-    uint32_t data_u32
-);
+    uint32_t data_u32)
+{
+    return OldPacket_AddUint16(packet_ptr, (uint16_t)(data_u32 & 0xFFFFU)) &&
+           OldPacket_AddUint16(packet_ptr, (uint16_t)((data_u32 >> 16) & 0xFFFFU));
+}
 
 /**
  * @brief Add multiple bytes from an array
  *
- * @param[in,out] packet_ptr  Pointer to packet builder (must not be NULL)
- * @param[in]     data_ptr    Pointer to byte array (must not be NULL)
- * @param[in]     data_len    Number of bytes to add
- *
  * @return true if all bytes added, false if insufficient space or NULL pointer
  *
- * @pre packet_ptr and data_ptr must not be NULL
- * @pre data_len must be > 0
- * @post If true, all bytes from data_ptr are copied
- *
  * @note If return is false, partial data may have been added
  */
-bool OldPacket_AddBytes(
+constexpr bool OldPacket_AddBytes(
     OldPacket_t *packet_ptr,
     const uint8_t *data_ptr,
-    uint8_t data_len
-);
+    uint8_t data_len)
+{
+    bool result = ((packet_ptr != NULL) && (data_ptr != NULL));
+
+    for (uint8_t i = 0U; result && (i < data_len); i++) {
+        result = OldPacket_AddByte(packet_ptr, data_ptr[i]);
+    }
+
+    return result;
+}
 
 /**
- * @brief Finalize packet by adding checksum and end byte
+ * @brief Finalize packet by adding checksum and end bytes
  *
  * This function MUST be called after all data is added. It:
- * 1. Updates the LENGTH field (buffer[1])
- * 2. Calculates and appends checksum (2 bytes, big-endian)
- * 3. Appends end byte (0xAA)
- *
- * @param[in,out] packet_ptr  Pointer to packet builder (must not be NULL)
+ * 1. Updates the LENGTH field (buffer[1] = total - 4)
+ * 2. Appends checksum (sum of all previous bytes, 1 byte)
+ * 3. Appends end bytes (0xEB 0xAA)
  *
  * @return true if finalized successfully, false if buffer overflow or NULL pointer
  *
- * @pre packet_ptr must not be NULL
- * @pre packet must contain at least header (4 bytes)
- * @post After success, no more data can be added
- *
- * @note After finalization, no more data can be added
  * @warning Always call GetBuffer/GetLength only AFTER Finalize
- *
- * @par Checksum Algorithm:
- * Sum of all bytes from start to end of data (before checksum)
  */
-bool OldPacket_Finalize(
-    OldPacket_t *packet_ptr
-);
+constexpr bool OldPacket_Finalize(
+    OldPacket_t *packet_ptr)
+{
+    bool result = false;
+
+    if ((packet_ptr != NULL) && (packet_ptr->length >= OLD_PACKET_HEADER_SIZE) &&
+        (packet_ptr->length <= (PACKET_BUILDER_MAX_SIZE - OLD_PACKET_TAIL_SIZE))) {
+        const uint8_t pos = packet_ptr->length;
+
+        packet_ptr->buffer[1] = (uint8_t)(pos + OLD_PACKET_TAIL_SIZE - 4U);
+        packet_ptr->buffer[pos] = OldPacket_Checksum(packet_ptr->buffer, pos);
+        packet_ptr->buffer[pos + 1U] = OLD_PACKET_END1;
+        packet_ptr->buffer[pos + 2U] = OLD_PACKET_END2;
+        packet_ptr->length = (uint8_t)(pos + OLD_PACKET_TAIL_SIZE);
+        result = true;
+    }
+
+    return result;
+}
 
 /**
  * @brief Get pointer to finalized packet buffer
  *
- * @param[in] packet_ptr  Pointer to finalized packet (must not be NULL)
- *
  * @return Pointer to internal buffer, or NULL if packet_ptr is NULL
  *
- * @pre packet_ptr must not be NULL
- * @pre OldPacket_Finalize must have been called
- *
  * @warning Only call after OldPacket_Finalize()
- * @note Returned pointer is valid until packet structure is destroyed
- * @note MISRA-C Rule 8.13: Pointer declared const as content not modified
  */
-const uint8_t* OldPacket_GetBuffer(
-    const OldPacket_t *packet_ptr
-);
+constexpr const uint8_t* OldPacket_GetBuffer(
+    const OldPacket_t *packet_ptr)
+{
+    return (packet_ptr != NULL) ? packet_ptr->buffer : (const uint8_t *)NULL;
+}
 
 /**
  * @brief Get total length of finalized packet
  *
- * @param[in] packet_ptr  Pointer to finalized packet (must not be NULL)
- *
  * @return Total packet length in bytes, or 0 if packet_ptr is NULL
  *
- * @pre packet_ptr must not be NULL
- * @pre OldPacket_Finalize must have been called
- *
  * @warning Only call after OldPacket_Finalize()
  */
-uint8_t OldPacket_GetLength(
-    const OldPacket_t *packet_ptr
-);
+constexpr uint8_t OldPacket_GetLength(
+    const OldPacket_t *packet_ptr)
+{
+    return (packet_ptr != NULL) ? packet_ptr->length : 0U;
+}
+
+/**
+ * @brief Check a finalized packet: LENGTH, checksum and end bytes agree
+ *
+ * @note Intended for static_assert on constexpr frames
+ */
+constexpr bool OldPacket_IsValid(
+    const OldPacket_t *packet_ptr)
+{
+    return (packet_ptr != NULL) &&
+           (packet_ptr->length >= (OLD_PACKET_HEADER_SIZE + OLD_PACKET_TAIL_SIZE)) &&
+           (packet_ptr->buffer[1] == (uint8_t)(packet_ptr->length - 4U)) &&
+           (packet_ptr->buffer[packet_ptr->length - 3U] ==
+                OldPacket_Checksum(packet_ptr->buffer, (uint8_t)(packet_ptr->length - 3U))) &&
+           (packet_ptr->buffer[packet_ptr->length - 2U] == OLD_PACKET_END1) &&
+           (packet_ptr->buffer[packet_ptr->length - 1U] == OLD_PACKET_END2);
+}
+
+/**
+ * @brief Build a complete old format packet in one expression
+ *
+ * @param[in] data  DATA section (reserve byte first)
+ *
+ * @par Example:
+ * @code
+ * constexpr uint8_t ack[] = {0x33U, 0x01U};
+ * constexpr OldPacket_t nuc_ack = OldPacket_Make(OLD_PACKET_RX, 0x16U, ack);
+ * static_assert(nuc_ack.buffer[6] == 0xA4U, "NUC ACK checksum");
+ * @endcode
+ */
+template <size_t N>
+constexpr OldPacket_t OldPacket_Make(
+    OldPacketType_t packet_type,
+    uint8_t cmd_id,
+    const uint8_t (&data)[N])
+{
+    OldPacket_t pkt = {};
+
+    OldPacket_Init(&pkt, packet_type, cmd_id);
+    (void)OldPacket_AddBytes(&pkt, data, (uint8_t)N);
+    (void)OldPacket_Finalize(&pkt);
+    return pkt;
+}
 
 /*============================================================================*/
 /* New Format Packet Generator API                                           */
@@ -282,128 +371,195 @@ uint8_t OldPacket_GetLength(
  * Sets up packet header: [0x55] [0xAA] [0x00] [type]
  *
  * @param[out] packet_ptr   Pointer to packet builder structure (must not be NULL)
- * @param[in]  packet_type  Command type byte
- *
- * @return void
- *
- * @pre packet_ptr must not be NULL
- * @post packet initialized with header [0x55][0xAA][0][type]
+ * @param[in]  packet_type  First command byte (B1) or response status
  *
  * @par Common Types:
  * - 0x01: Control command
  * - 0x02: Configuration command
- * - 0x03: Query command
  * - 0x00: Response/ACK
  */
-void NewPacket_Init(
+constexpr void NewPacket_Init(
     NewPacket_t *packet_ptr,
-    uint8_t packet_type
-);
+    uint8_t packet_type)
+{
+    if (packet_ptr != NULL) {
+        for (uint8_t i = 0U; i < PACKET_BUILDER_MAX_SIZE; i++) {
+            packet_ptr->buffer[i] = 0U;
+        }
+
+        /* Build header: [0x55] [0xAA] [LENGTH] [TYPE] */
+        packet_ptr->buffer[0] = NEW_PACKET_START1;
+        packet_ptr->buffer[1] = NEW_PACKET_START2;
+        packet_ptr->buffer[2] = 0U;          /* Length - updated in Finalize */
+        packet_ptr->buffer[3] = packet_type;
+        packet_ptr->length = NEW_PACKET_HEADER_SIZE;
+    }
+}
 
 /**
  * @brief Add a single byte to new format packet
  *
- * @param[in,out] packet_ptr  Pointer to packet builder (must not be NULL)
- * @param[in]     data_byte   Byte to add
- *
  * @return true if added successfully, false if buffer full or NULL pointer
  *
- * @pre packet_ptr must not be NULL
- * @post If true, byte added and length incremented
- *
- * @note Reserves space for end byte (0xF0)
+ * @note Reserves space for XOR and end byte (2 bytes)
  */
-bool NewPacket_AddByte(
+constexpr bool NewPacket_AddByte(
     NewPacket_t *packet_ptr,
-    uint8_t data_byte
-);
+    uint8_t data_byte)
+{
+    bool result = false;
+
+    if ((packet_ptr != NULL) &&
+        (packet_ptr->length < (PACKET_BUILDER_MAX_SIZE - NEW_PACKET_TAIL_SIZE))) {
+        packet_ptr->buffer[packet_ptr->length] = data_byte;
+        packet_ptr->length = (uint8_t)(packet_ptr->length + 1U);
+        result = true;
+    }
+
+    return result;
+}
 
 /**
- * @brief Add a 16-bit value (little-endian) to new format packet
- *
- * @param[in,out] packet_ptr  Pointer to packet builder (must not be NULL)
- * @param[in]     data_u16    16-bit value to add
+ * @brief Add a 16-bit value, stored as [LOW_BYTE][HIGH_BYTE]
  *
  * @return true if added successfully, false if insufficient space or NULL pointer
- *
- * @pre packet_ptr must not be NULL
- * @post Value stored as [LOW_BYTE][HIGH_BYTE]
  */
-bool NewPacket_AddUint16(
+constexpr bool NewPacket_AddUint16(
     NewPacket_t *packet_ptr,
-    uint16_t data_u16
-);
+    uint16_t data_u16)
+{
+    return NewPacket_AddByte(packet_ptr, (uint8_t)(data_u16 & 0xFFU)) &&
+           NewPacket_AddByte(packet_ptr, (uint8_t)((data_u16 >> 8) & 0xFFU));
+}
 
 /**
  * @brief Add byte array to new format packet
  *
- * @param[in,out] packet_ptr  Pointer to packet builder (must not be NULL)
- * @param[in]     data_ptr    Pointer to byte array (must not be NULL)
- * @param[in]     data_len    Number of bytes to add
- *
  * @return true if all bytes added, false if insufficient space or NULL pointer
- *
- * @pre packet_ptr and data_ptr must not be NULL
- * @pre data_len must be > 0
  */
-bool NewPacket_AddBytes(
+constexpr bool NewPacket_AddBytes(
     NewPacket_t *packet_ptr,
     const uint8_t *data_ptr,
-    uint8_t data_len
-);
+    uint8_t data_len)
+{
+    bool result = ((packet_ptr != NULL) && (data_ptr != NULL));
+
+    for (uint8_t i = 0U; result && (i < data_len); i++) {
+        result = NewPacket_AddByte(packet_ptr, data_ptr[i]);
+    }
+
+    return result;
+}
 
 /**
  * @brief Finalize new format packet
  *
  * This function:
- * 1. Appends end byte (0xF0)
- * 2. Updates LENGTH field (buffer[2]) with total packet length
- *
- * @param[in,out] packet_ptr  Pointer to packet builder (must not be NULL)
+ * 1. Updates LENGTH field (buffer[2] = total - 5)
+ * 2. Appends XOR of LENGTH .. last data byte
+ * 3. Appends end byte (0xF0)
  *
  * @return true if finalized successfully, false if buffer overflow or NULL pointer
- *
- * @pre packet_ptr must not be NULL
- * @pre packet must contain at least header (4 bytes)
- * @post After success, packet is complete and ready to send
- *
- * @note No checksum is used in new format - end byte is sufficient
  */
-bool NewPacket_Finalize(
-    NewPacket_t *packet_ptr
-);
+constexpr bool NewPacket_Finalize(
+    NewPacket_t *packet_ptr)
+{
+    bool result = false;
+
+    if ((packet_ptr != NULL) && (packet_ptr->length >= NEW_PACKET_HEADER_SIZE) &&
+        (packet_ptr->length <= (PACKET_BUILDER_MAX_SIZE - NEW_PACKET_TAIL_SIZE))) {
+        const uint8_t pos = packet_ptr->length;
+
+        packet_ptr->buffer[2] = (uint8_t)(pos - 3U);
+        packet_ptr->buffer[pos] = NewPacket_Checksum(&packet_ptr->buffer[2], (uint8_t)(pos - 2U));
+        packet_ptr->buffer[pos + 1U] = NEW_PACKET_END;
+        packet_ptr->length = (uint8_t)(pos + NEW_PACKET_TAIL_SIZE);
+        result = true;
+    }
+
+    return result;
+}
 
 /**
  * @brief Get pointer to finalized new format packet buffer
  *
- * @param[in] packet_ptr  Pointer to finalized packet (must not be NULL)
- *
- * @return Pointer to internal buffer, or NULL if packet_ptr is NULL
- *
- * @pre packet_ptr must not be NULL
- * @pre NewPacket_Finalize must have been called
- *
  * @warning Only call after NewPacket_Finalize()
  */
-const uint8_t* NewPacket_GetBuffer(
-    const NewPacket_t *packet_ptr
-);
+constexpr const uint8_t* NewPacket_GetBuffer(
+    const NewPacket_t *packet_ptr)
+{
+    return (packet_ptr != NULL) ? packet_ptr->buffer : (const uint8_t *)NULL;
+}
 
 /**
  * @brief Get total length of finalized new format packet
  *
- * @param[in] packet_ptr  Pointer to finalized packet (must not be NULL)
+ * @warning Only call after NewPacket_Finalize()
+ */
+constexpr uint8_t NewPacket_GetLength(
+    const NewPacket_t *packet_ptr)
+{
+    return (packet_ptr != NULL) ? packet_ptr->length : 0U;
+}
+
+/**
+ * @brief Check a finalized packet: start, LENGTH, XOR and end byte agree
  *
- * @return Total packet length in bytes, or 0 if packet_ptr is NULL
+ * @note Intended for static_assert on constexpr frames
+ */
+constexpr bool NewPacket_IsValid(
+    const NewPacket_t *packet_ptr)
+{
+    return (packet_ptr != NULL) &&
+           (packet_ptr->length >= (NEW_PACKET_HEADER_SIZE + NEW_PACKET_TAIL_SIZE)) &&
+           (packet_ptr->buffer[0] == NEW_PACKET_START1) &&
+           (packet_ptr->buffer[1] == NEW_PACKET_START2) &&
+           (packet_ptr->buffer[2] == (uint8_t)(packet_ptr->length - 5U)) &&
+           (packet_ptr->buffer[packet_ptr->length - 2U] ==
+                NewPacket_Checksum(&packet_ptr->buffer[2], (uint8_t)(packet_ptr->length - 4U))) &&
+           (packet_ptr->buffer[packet_ptr->length - 1U] == NEW_PACKET_END);
+}
+
+/**
+ * @brief Build a complete new format packet in one expression
  *
- * @pre packet_ptr must not be NULL
- * @pre NewPacket_Finalize must have been called
+ * @param[in] cmd      Command bytes B1 B2 B3
+ * @param[in] payload  Payload bytes
  *
- * @warning Only call after NewPacket_Finalize()
+ * @par Example:
+ * @code
+ * constexpr uint8_t zoom_x1[] = {0x00U, 0x00U, 0x00U, 0x08U};
+ * constexpr NewPacket_t pkt = NewPacket_Make(zoom_setter_new, zoom_x1);
+ * static_assert(pkt.buffer[10] == 0x0BU, "zoom x1 XOR");
+ * @endcode
+ */
+template <size_t N>
+constexpr NewPacket_t NewPacket_Make(
+    const uint8_t (&cmd)[3],
+    const uint8_t (&payload)[N])
+{
+    NewPacket_t pkt = {};
+
+    NewPacket_Init(&pkt, cmd[0]);
+    (void)NewPacket_AddByte(&pkt, cmd[1]);
+    (void)NewPacket_AddByte(&pkt, cmd[2]);
+    (void)NewPacket_AddBytes(&pkt, payload, (uint8_t)N);
+    (void)NewPacket_Finalize(&pkt);
+    return pkt;
+}
+
+/**
+ * @brief Build a response / status-only new format packet: 55 AA 01 [status] XOR F0
  */
-uint8_t NewPacket_GetLength(
-    const NewPacket_t *packet_ptr
-);
+constexpr NewPacket_t NewPacket_Make(
+    uint8_t status)
+{
+    NewPacket_t pkt = {};
+
+    NewPacket_Init(&pkt, status);
+    (void)NewPacket_Finalize(&pkt);
+    return pkt;
+}
 
 /*============================================================================*/
 /* Packet Parsing Helper Functions                                           */
@@ -412,106 +568,87 @@ uint8_t NewPacket_GetLength(
 /**
  * @brief Extract command ID from old format packet
  *
- * @param[in] packet_ptr  Pointer to received packet buffer (must not be NULL)
- *
  * @return Command ID byte (packet[3]), or 0 if packet_ptr is NULL
  *
- * @pre packet_ptr must point to valid packet buffer
- * @post Return value is packet[3]
- *
- * @note Does not validate packet integrity - use VerifyPacket first
+ * @note Does not validate packet integrity - verify the packet first
  */
-uint8_t OldPacket_GetCommandId(
-    const uint8_t *packet_ptr
-);
+constexpr uint8_t OldPacket_GetCommandId(
+    const uint8_t *packet_ptr)
+{
+    return (packet_ptr != NULL) ? packet_ptr[3] : 0U;
+}
 
 /**
  * @brief Extract a byte from old format packet data section
  *
- * @param[in]  packet_ptr  Pointer to packet buffer (must not be NULL)
- * @param[in]  offset      Offset within data section (0-based)
- * @param[out] value_ptr   Pointer to store extracted byte (must not be NULL)
- *
  * @return true if extracted successfully, false if NULL pointer
  *
- * @pre packet_ptr and value_ptr must not be NULL
- * @post If true, *value_ptr contains extracted byte
- *
  * @note Data section starts at packet[4]
  * @warning Does not check if offset is within packet bounds
- *
- * @par Example:
- * @code
- * uint8_t zoom;
- * bool result = OldPacket_GetByte(rx_packet, 0U, &zoom);
- * if (result) {
- *     // Use zoom value
- * }
- * @endcode
  */
-bool OldPacket_GetByte(
+constexpr bool OldPacket_GetByte(
     const uint8_t *packet_ptr,
     uint8_t offset,
-    uint8_t *value_ptr
-);
+    uint8_t *value_ptr)
+{
+    bool result = false;
+
+    if ((packet_ptr != NULL) && (value_ptr != NULL)) {
+        *value_ptr = packet_ptr[4U + offset];
+        result = true;
+    }
+
+    return result;
+}
 
 /**
- * @brief Extract a 16-bit value from old format packet (little-endian)
- *
- * @param[in]  packet_ptr  Pointer to packet buffer (must not be NULL)
- * @param[in]  offset      Offset within data section (0-based)
- * @param[out] value_ptr   Pointer to store extracted 16-bit value (must not be NULL)
+ * @brief Extract a 16-bit value from old format packet ([LOW_BYTE] [HIGH_BYTE] at offset)
  *
  * @return true if extracted successfully, false if NULL pointer
- *
- * @pre packet_ptr and value_ptr must not be NULL
- * @post If true, *value_ptr contains 16-bit value in host byte order
- *
- * @note Reads [LOW_BYTE] [HIGH_BYTE] at offset
  */
-bool OldPacket_GetUint16(
+constexpr bool OldPacket_GetUint16(
     const uint8_t *packet_ptr,
     uint8_t offset,
-    uint16_t *value_ptr
-);
+    uint16_t *value_ptr)
+{
+    bool result = false;
+
+    if ((packet_ptr != NULL) && (value_ptr != NULL)) {
+        *value_ptr = (uint16_t)((uint16_t)packet_ptr[4U + offset] |
+                                ((uint16_t)packet_ptr[4U + offset + 1U] << 8));
+        result = true;
+    }
+
+    return result;
+}
 
 /**
  * @brief Extract a byte from new format packet data section
  *
- * @param[in]  packet_ptr  Pointer to packet buffer (must not be NULL)
- * @param[in]  offset      Offset within data section (0-based)
- * @param[out] value_ptr   Pointer to store extracted byte (must not be NULL)
- *
  * @return true if extracted successfully, false if NULL pointer
  *
- * @pre packet_ptr and value_ptr must not be NULL
- * @post If true, *value_ptr contains extracted byte
- *
  * @note Data section starts at packet[4]
  */
-bool NewPacket_GetByte(
+constexpr bool NewPacket_GetByte(
     const uint8_t *packet_ptr,
     uint8_t offset,
-    uint8_t *value_ptr
-);
+    uint8_t *value_ptr)
+{
+    return OldPacket_GetByte(packet_ptr, offset, value_ptr);
+}
 
 /**
  * @brief Extract a 16-bit value from new format packet (little-endian)
  *
- * @param[in]  packet_ptr  Pointer to packet buffer (must not be NULL)
- * @param[in]  offset      Offset within data section (0-based)
- * @param[out] value_ptr   Pointer to store extracted 16-bit value (must not be NULL)
- *
  * @return true if extracted successfully, false if NULL pointer
- *
- * @pre packet_ptr and value_ptr must not be NULL
- * @post If true, *value_ptr contains 16-bit value in host byte order
  */
-bool NewPacket_GetUint16(
+constexpr bool NewPacket_GetUint16(
     const uint8_t *packet_ptr,
     uint8_t offset,
-    uint16_t *value_ptr
-);
+    uint16_t *value_ptr)
+{
+    return OldPacket_GetUint16(packet_ptr, offset, value_ptr);
+}
 
 #endif /* PACKET_BUILDER_H */
 
@@ -0,0 +1,46 @@
+/**
+ * @file packet_view.h
+ * @brief Cozumlenmis (parse edilmis) kontrol / kamera frame gorunumleri
+ *
+ * Frame, framer tarafindan bir kez dogrulanir ve alanlari bir kez ayrilir;
+ * sonraki asamalar (eslestirme, ceviri, bekleyen komut kaydi, yanit uretimi)
+ * ham byte + uzunluk yerine bu gorunumu alir ve frame'i tekrar dogrulamaz.
+ * Gorunum bytelari kopyalamaz, bytes frame'in bitisik halini gosterir.
+ *
+ * Gorunumler command_handler.cpp'deki CtrlPacketView_* / CamPacketView_*
+ * fonksiyonlari ile kurulur.
+ */
+
+#ifndef PACKET_VIEW_H_
+#define PACKET_VIEW_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+
+/**
+ * @brief Kontrol frame'i: AA [LEN] KB0 KB1 [RES] [PAYLOAD] [CS] EB AA
+ */
+typedef struct {
+    const uint8_t *bytes;       /* frame'in ilk byte'i (START) */
+    const uint8_t *payload;     /* bytes[5], payload_len 0 ise okunmaz */
+    uint16_t key;               /* MAKE_CTRL_KEY(KB0, KB1) */
+    uint8_t len;                /* toplam boy = LEN + 4 */
+    uint8_t reserve;            /* 01 SET / 00 READ / 33 yanit */
+    uint8_t payload_len;        /* len - 8 (read komutunda 0) */
+    bool checksum_ok;           /* START, trailer ve CS dogrulandi */
+} CtrlPacketView_t;
+
+/**
+ * @brief Kamera frame'i: 55 AA [LEN] [BODY] [XOR] F0
+ *
+ * body, komutta B1 B2 B3 + payload, yanitta STATUS + payload'dur.
+ */
+typedef struct {
+    const uint8_t *bytes;       /* frame'in ilk byte'i (0x55) */
+    const uint8_t *body;        /* bytes[3] */
+    uint8_t len;                /* toplam boy = LEN + 5 */
+    uint8_t body_len;           /* LEN alani */
+    bool checksum_ok;           /* baslangic, F0 ve XOR dogrulandi */
+} CamPacketView_t;
+
+#endif /* PACKET_VIEW_H_ */
@@ -0,0 +1,290 @@
+/**
+ * @file translator_dsl.h
+ * @brief Derleme aninda olusturulan kontrol -> kamera cevirici adimlari
+ *
+ * Her komutun cevirisi, adim sablonlarinin (TrConst/TrCopy/TrScale8/TrLookup)
+ * TrCamCmd icinde birlestirilmesiyle tanimlanir. Derleyici her komut icin
+ * dallanmasiz, sabit ofsetli tek bir fonksiyon uretir:
+ *   - baslik (55 AA LEN B1 B2 B3), LEN ve trailer derleme aninda bilinir
+ *   - sabit bytelarin XOR katkisi derleme aninda hesaplanir; calisma aninda
+ *     sadece kontrol paketinden gelen bytelar XOR'a katilir
+ *   - kontrol paketi boy kontrolu tek seferde yapilir (en buyuk ofsete gore)
+ *
+ * Ornek (command_map icinde tek satir):
+ *   &TrCamCmd<0x02, 0x01, 0x08, TrConst<0x00, 3>, TrCopy<5, 1> >::translate
+ *
+ * Uretilen kamera paketi: 55 AA [LEN] B1 B2 B3 [adimlar...] [XOR] F0
+ *   LEN = 3 + payload boyu, toplam boy = LEN + CAM_PKT_LEN_OVERHEAD
+ */
+#ifndef TRANSLATOR_DSL_H_
+#define TRANSLATOR_DSL_H_
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include "command_handler.h"
+#include "packet_builder.h"
+
+/* Translator'a verilen kamera tamponunun boyu (UART_HandleControlFrame cam_pkt) */
+#define TR_CAM_PKT_MAX          (64U)
+
+/* Kontrol paketinde payload'dan sonra gelen byte sayisi: CS EB AA */
+#define TR_CTRL_TAIL_SIZE       (3U)
+
+
+/* Sabit byte: V degerini N kez yazar. XOR katkisi derleme aninda. */
+template <uint8_t V, uint8_t N = 1U>
+struct TrConst {
+    static constexpr uint8_t size = N;
+    static constexpr uint8_t min_ctrl = 0U;
+    static constexpr uint8_t const_xor = ((N & 1U) != 0U) ? V : 0U;
+
+    static inline bool emit(const uint8_t *ctrl, uint8_t *out, uint8_t &x)
+    {
+        (void)ctrl;
+        (void)x;
+        for (uint8_t k = 0U; k < N; k++) {
+            out[k] = V;
+        }
+        return true;
+    }
+};
+
+/* Kopya: kontrol paketinin Off ofsetinden N byte */
+template <uint8_t Off, uint8_t N = 1U>
+struct TrCopy {
+    static constexpr uint8_t size = N;
+    static constexpr uint8_t min_ctrl = Off + N + TR_CTRL_TAIL_SIZE;
+    static constexpr uint8_t const_xor = 0U;
+
+    static inline bool emit(const uint8_t *ctrl, uint8_t *out, uint8_t &x)
+    {
+        for (uint8_t k = 0U; k < N; k++) {
+            out[k] = ctrl[Off + k];
+            x ^= out[k];
+        }
+        return true;
+    }
+};
+
+/* Olcekleme: ctrl[Off] * Mul / Div (255'te doyar), N kez yazilir */
+template <uint8_t Off, uint8_t Mul, uint8_t Div, uint8_t N = 1U>
+struct TrScale8 {
+    static_assert(Div != 0U, "TrScale8: Div sifir olamaz");
+
+    static constexpr uint8_t size = N;
+    static constexpr uint8_t min_ctrl = Off + 1U + TR_CTRL_TAIL_SIZE;
+    static constexpr uint8_t const_xor = 0U;
+
+    static inline bool emit(const uint8_t *ctrl, uint8_t *out, uint8_t &x)
+    {
+        uint32_t r = ((uint32_t)ctrl[Off] * Mul) / Div;
+        const uint8_t v = (r > 0xFFU) ? 0xFFU : (uint8_t)r;
+
+        for (uint8_t k = 0U; k < N; k++) {
+            out[k] = v;
+        }
+        if ((N & 1U) != 0U) {
+            x ^= v;
+        }
+        return true;
+    }
+};
+
+/* Tablo: Table[ctrl[Off]], indeks tablo disindaysa ceviri reddedilir */
+template <uint8_t Off, const uint8_t *Table, uint8_t Len, uint8_t N = 1U>
+struct TrLookup {
+    static constexpr uint8_t size = N;
+    static constexpr uint8_t min_ctrl = Off + 1U + TR_CTRL_TAIL_SIZE;
+    static constexpr uint8_t const_xor = 0U;
+
+    static inline bool emit(const uint8_t *ctrl, uint8_t *out, uint8_t &x)
+    {
+        const uint8_t i = ctrl[Off];
+        uint8_t v;
+
+        if (i >= Len) {
+            return false;
+        }
+        v = Table[i];
+        for (uint8_t k = 0U; k < N; k++) {
+            out[k] = v;
+        }
+        if ((N & 1U) != 0U) {
+            x ^= v;
+        }
+        return true;
+    }
+};
+
+
+/* Adim listesi: boy, gereken kontrol boyu ve sabit XOR derleme aninda toplanir,
+   emit() her adimi sabit ofsetle ardisik cagirir (inline -> duz kod). */
+template <class... Steps>
+struct TrSteps;
+
+template <>
+struct TrSteps<> {
+    static constexpr uint8_t size = 0U;
+    static constexpr uint8_t min_ctrl = 0U;
+    static constexpr uint8_t const_xor = 0U;
+
+    static inline bool emit(const uint8_t *ctrl, uint8_t *out, uint8_t &x)
+    {
+        (void)ctrl;
+        (void)out;
+        (void)x;
+        return true;
+    }
+};
+
+template <class S, class... Rest>
+struct TrSteps<S, Rest...> {
+    static constexpr uint8_t size = S::size + TrSteps<Rest...>::size;
+    static constexpr uint8_t min_ctrl = (S::min_ctrl > TrSteps<Rest...>::min_ctrl) ?
+                                        S::min_ctrl : TrSteps<Rest...>::min_ctrl;
+    static constexpr uint8_t const_xor = S::const_xor ^ TrSteps<Rest...>::const_xor;
+
+    static inline bool emit(const uint8_t *ctrl, uint8_t *out, uint8_t &x)
+    {
+        return S::emit(ctrl, out, x) && TrSteps<Rest...>::emit(ctrl, out + S::size, x);
+    }
+};
+
+
+/* Bir kamera komutu: B1 B2 B3 + adimlar. translate, CtrlToCamTranslator_t'dir. */
+template <uint8_t B1, uint8_t B2, uint8_t B3, class... Steps>
+struct TrCamCmd {
+    typedef TrSteps<Steps...> Body;
+
+    static constexpr uint8_t len_field = 3U + Body::size;
+    static constexpr uint8_t total = len_field + CAM_PKT_LEN_OVERHEAD;
+    static constexpr uint8_t head_xor = len_field ^ B1 ^ B2 ^ B3 ^ Body::const_xor;
+    static constexpr uint8_t min_ctrl = (Body::min_ctrl > CTRL_PKT_MIN_SIZE) ?
+                                        Body::min_ctrl : CTRL_PKT_MIN_SIZE;
+
+    static_assert(total <= TR_CAM_PKT_MAX, "TrCamCmd: kamera paketi tampona sigmiyor");
+
+    static bool translate(const CtrlPacketView_t *ctrl_view_ptr,
+                          uint8_t *cam_packet_ptr, uint8_t *cam_len_ptr)
+    {
+        uint8_t x = head_xor;
+
+        if ((ctrl_view_ptr == NULL) || (cam_packet_ptr == NULL) ||
+            (cam_len_ptr == NULL) || (ctrl_view_ptr->len < min_ctrl)) {
+            return false;
+        }
+
+        cam_packet_ptr[0] = CAM_PKT_START1;
+        cam_packet_ptr[1] = CAM_PKT_START2;
+        cam_packet_ptr[2] = len_field;
+        cam_packet_ptr[3] = B1;
+        cam_packet_ptr[4] = B2;
+        cam_packet_ptr[5] = B3;
+        if (!Body::emit(ctrl_view_ptr->bytes, &cam_packet_ptr[6], x)) {
+            return false;
+        }
+        cam_packet_ptr[6U + Body::size] = x;
+        cam_packet_ptr[7U + Body::size] = CAM_PKT_END;
+
+        *cam_len_ptr = total;
+        return true;
+    }
+};
+
+
+/* ---- Onceden hazirlanmis kamera frame'leri (sonlu payload kumeleri) ----
+ * Payload'u birkac degerden birini alan set komutlari icin her (komut, deger)
+ * ciftinin tam frame'i (LEN, XOR, F0 dahil) derleme aninda uretilip flash'a
+ * konur. Calisma aninda ceviri = secici bytelarin tabloda aranmasi; frame
+ * kopyalanmadan flash'tan DMA ile gonderilir (CamFrameSet_t, command_handler.h).
+ */
+
+/* N frame, her biri KeyLen byte secici + PayLen byte payload */
+template <uint8_t N, uint8_t KeyLen, uint8_t PayLen>
+struct TrFrameTable {
+    static constexpr uint8_t count = N;
+    static constexpr uint8_t key_len = KeyLen;
+    static constexpr uint8_t frame_len = 3U + PayLen + CAM_PKT_LEN_OVERHEAD;
+
+    static_assert(frame_len <= TR_CAM_PKT_MAX, "TrFrameTable: kamera paketi tampona sigmiyor");
+
+    uint8_t keys[N][(KeyLen != 0U) ? KeyLen : 1U];
+    uint8_t frames[N][frame_len];
+};
+
+/* Tablonun i. frame'ini yazar: 55 AA LEN B1 B2 B3 payload XOR F0 */
+template <class T>
+constexpr void TrFrameRender(T &t, uint8_t i, uint8_t b1, uint8_t b2, uint8_t b3, const uint8_t *payload)
+{
+    const uint8_t pay_len = (uint8_t)(T::frame_len - 3U - CAM_PKT_LEN_OVERHEAD);
+    uint8_t k = 0U;
+
+    t.frames[i][0] = CAM_PKT_START1;
+    t.frames[i][1] = CAM_PKT_START2;
+    t.frames[i][2] = (uint8_t)(3U + pay_len);
+    t.frames[i][3] = b1;
+    t.frames[i][4] = b2;
+    t.frames[i][5] = b3;
+    for (k = 0U; k < pay_len; k++) {
+        t.frames[i][6U + k] = payload[k];
+    }
+    t.frames[i][6U + pay_len] = NewPacket_Checksum(&t.frames[i][2], (uint8_t)(4U + pay_len));
+    t.frames[i][7U + pay_len] = CAM_PKT_END;
+}
+
+/* Secici anahtarlar kesin artan mi (ikili arama + tekrar yok) */
+template <class T>
+constexpr bool TrFrameKeysSorted(const T &t)
+{
+    for (uint8_t i = 1U; i < T::count; i++) {
+        uint8_t k = 0U;
+        while ((k < T::key_len) && (t.keys[i - 1U][k] == t.keys[i][k])) {
+            k++;
+        }
+        if ((k == T::key_len) || (t.keys[i - 1U][k] > t.keys[i][k])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+
+/* ---- Sabit kontrol yanitlari (derleme aninda) ----
+ * 55 LEN 00 CMD 33 [payload] CS EB AA, LEN = 4 + payload boyu,
+ * CS = CalculateCtrlChecksum ile ayni (0..CS'den onceki byte toplami).
+ * Frame packet_builder.h'deki OldPacket_* ile kurulur, tam boyda bir diziye
+ * alinir (256 satirlik ACK tablosu OldPacket_t tamponunu tasimaz).
+ */
+template <uint8_t PayLen>
+struct TrCtrlFrame {
+    static constexpr uint8_t size = PayLen + 8U;
+    uint8_t b[size];
+};
+
+template <uint8_t PayLen>
+constexpr TrCtrlFrame<PayLen> TrCtrlResponse(uint8_t cmd, const uint8_t (&payload)[PayLen])
+{
+    TrCtrlFrame<PayLen> f = {};
+    OldPacket_t pkt = {};
+
+    static_assert(TrCtrlFrame<PayLen>::size <= PACKET_BUILDER_MAX_SIZE, "TrCtrlResponse: yanit OldPacket_t'ye sigmiyor");
+
+    OldPacket_Init(&pkt, OLD_PACKET_RX, cmd);
+    (void)OldPacket_AddByte(&pkt, CTRL_PKT_RESP_RESERVE);
+    (void)OldPacket_AddBytes(&pkt, payload, PayLen);
+    (void)OldPacket_Finalize(&pkt);
+    for (uint8_t k = 0U; k < TrCtrlFrame<PayLen>::size; k++) {
+        f.b[k] = pkt.buffer[k];
+    }
+    return f;
+}
+
+/* Tek byte durum yaniti; set ACK'i icin status = CTRL_PKT_RESP_ACK_BYTE */
+constexpr TrCtrlFrame<1U> TrCtrlAck(uint8_t cmd, uint8_t status = CTRL_PKT_RESP_ACK_BYTE)
+{
+    const uint8_t pl[1] = { status };
+    return TrCtrlResponse(cmd, pl);
+}
+
+#endif /* TRANSLATOR_DSL_H_ */
@@ -8,6 +8,7 @@
 
 #include <stdint.h>
 #include <stdbool.h>
+#include "packet_view.h"
 
 
 
@@ -26,20 +27,158 @@ extern UART_HandleTypeDef huart2; /* control UART (degistirilebilir) */
 #define CONTROL_RX_BUFFER_SIZE  32U
 #define CAMERA_RX_BUFFER_SIZE   48U
 
+/* Frame icinde izin verilen en uzun hat boslugu (bit suresi, USART RTOR).
+   Bu kadar bosluktan sonra yarim kalan frame atilir. 115200 baud'da
+   30 bit ~ 260 us (yaklasik 3 karakter). */
+#define CONTROL_RX_GAP_BITS     30U
+#define CAMERA_RX_GAP_BITS      30U
+
+/* DMA dairesel alim tamponu (port basina). Frame'ler islenene kadar bu
+   halkada kalir; kuyruktaki frame'ler + yeni gelen burst'u tasiyabilmeli.
+   2'nin kuvveti olmali. */
+#define UART_RX_DMA_BUFFER_SIZE 256U
+
+/* Frame yerinde islenirken DMA'nin yazabilecegi byte payi. Frame'in sonu
+   yazma ucuna bundan yakinsa islemeden once kopyalanir (921600 baud'da
+   ~0.7 ms'lik alim). */
+#define UART_RX_COPY_MARGIN     64U
+
+/* DMA gonderim kuyrugu: port basina bekleyebilecek frame sayisi ve
+   kopyalanan bir frame'in en buyuk boyutu */
+#define UART_TX_QUEUE_DEPTH     8U
+#define UART_TX_SLOT_SIZE       64U
+
+/* ISR -> ana dongu frame kuyrugu: port basina bekleyebilecek tam frame sayisi
+   (2'nin kuvveti olmali) */
+#define UART_RX_FRAME_QUEUE_DEPTH  4U
+
+/* Port kimligi (kuyruk/sayac sorgulari icin) */
+typedef enum {
+    UART_PORT_CONTROL = 0U,   /* vehicle_uart */
+    UART_PORT_CAMERA,         /* cam_uart */
+    UART_PORT_COUNT
+} UartPort_t;
+
+/* Alim halkasi uzerindeki bir frame (kopyasiz gorunum).
+   seq: frame'in ilk byte'inin porttaki mutlak sirasi (halka indeksi = seq % boyut)
+   len: frame boyu. Bytelar halka sonunda bolunmus olabilir. */
+typedef struct {
+    const uint8_t *ring;
+    uint32_t seq;
+    uint16_t len;
+} FrameView_t;
+
+/* Frame'in i. byte'i */
+static inline uint8_t FrameView_At(const FrameView_t *view, uint16_t i)
+{
+    return view->ring[(view->seq + i) & (UART_RX_DMA_BUFFER_SIZE - 1U)];
+}
+
+/* Frame'i bitisik olarak dondurur: bolunmemisse halkadaki yerine isaret eder,
+   halka sonunda bolunmusse scratch'e (en az len byte) kopyalar. */
+const uint8_t *FrameView_Linear(const FrameView_t *view, uint8_t *scratch);
+
+/* USART kesmesi cevrim istatistigi (UART_IRQ_CYCLE_STATS == 1 iken dolar) */
+typedef struct {
+    uint32_t irq_count;     /* olculen kesme sayisi */
+    uint32_t cycles_last;   /* son kesmenin giris-cikis cevrimi */
+    uint32_t cycles_max;    /* en uzun kesme */
+    uint64_t cycles_total;  /* ortalama icin toplam */
+} UartIrqStats_t;
+
+/* Port basina hat hatasi sayaclari */
+typedef struct {
+    uint32_t ore;             /* overrun */
+    uint32_t fe;              /* framing */
+    uint32_t ne;              /* noise */
+    uint32_t pe;              /* parity */
+    uint32_t dma;             /* DMA transfer hatasi */
+    uint32_t frames_aborted;  /* hata nedeniyle birakilan yarim frame */
+    uint32_t frames_dropped;  /* kuyruk dolu / islenemeden uzerine yazilan frame */
+    uint32_t recoveries;      /* alimin yeniden kuruldugu durum sayisi */
+} UartErrorStats_t;
+
+/* Bir frame'in DMA gonderimi bittiginde (ISR baglaminda) cagrilir */
+typedef void (*UartTxCompleteCb_t)(UartPort_t port, const uint8_t *data, uint16_t len);
+
+
+
+/* Baslatma: her iki port icin DMA dairesel + IDLE alimini baslatir */
+void UART_Handler_Init(void);
 
 
-/* Baslatma: rx interrupt/IT alimini baslatir */
-void UART_Handler_Init(void);
+/* HAL_UARTEx_RxEventCallback icinden cagrilir (yarim/tam transfer ve IDLE).
+   pos: DMA'nin tampon icinde yazdigi son pozisyon. */
+void UART_Handler_RxEvent(UART_HandleTypeDef *huart, uint16_t pos);
+
+/* USART IRQ icinde RTOF (receiver timeout) set ise, HAL_UART_IRQHandler'dan
+   once cagrilir (bayrak temizlendikten sonra). Yarim frame'i birakir. */
+void UART_Handler_RxTimeout(UART_HandleTypeDef *huart);
+
+/* Register seviyesi backend (UART_DRIVER_LL == 1): USART IRQ'dan HAL'den once
+   cagrilir. RDR'yi dogrudan okuyup framer'a verir, hata ve RTO bayraklarini
+   temizler. true = kesme islendi, false = TX tamamlama icin HAL de cagrilmali */
+bool UART_Handler_IrqLL(UART_HandleTypeDef *huart);
+
+/* USART IRQ cikisinda olculen cevrim sayisini kaydeder */
+void UART_Handler_IrqCycles(UART_HandleTypeDef *huart, uint32_t cycles);
+
+/* Portun kesme cevrim istatistigini dondurur */
+void UART_GetIrqStats(UartPort_t port, UartIrqStats_t *stats);
+
+/* Portun hata sayaclarini dondurur (kesme guvenli kopya) */
+void UART_GetErrorStats(UartPort_t port, UartErrorStats_t *stats);
+
+/* Portun hata sayaclarini sifirlar */
+void UART_ResetErrorStats(UartPort_t port);
 
+/* Porta ait frame ici bosluk suresini (bit) degistirir */
+void UART_SetRxGapBits(UartPort_t port, uint32_t gap_bits);
 
-/* Bu fonksiyon cubeMX tarafindan cagirilacak HAL callback icerisinde cagrilacak */
-void UART_Handler_RxCplt(UART_HandleTypeDef *huart);
+/* Hat bosta kaldigi icin atilan yarim frame sayisi */
+uint32_t UART_GetRxGapAbortCount(UartPort_t port);
 
-/* Gonderme yardimcilari - bloklayici transmit (kisa paketler icin uygun) */
+/* Ana donguden cagrilir: ISR'larin kuyruga biraktigi tam frame'leri
+   dogrular, cevirir ve gonderir. Kesme baglaminda cagirmayin. */
+void UART_Handler_Process(void);
+
+/* ISR kuyrugu dolu oldugu icin atilan veya islenemeden uzerine yazilan
+   frame sayisi */
+uint32_t UART_GetRxFrameDropCount(UartPort_t port);
+
+/* Gecersiz aday frame sonrasi alinmis bytelarin yeniden tarandigi durum sayisi
+   (hat gurultusu / bozuk frame gostergesi) */
+uint32_t UART_GetRxResyncCount(UartPort_t port);
+
+/* HAL_UART_TxCpltCallback icinden cagrilir: kuyruktaki sonraki frame'i baslatir */
+void UART_Handler_TxCplt(UART_HandleTypeDef *huart);
+
+/* Gonderme yardimcilari - bloklamaz: frame kuyruga kopyalanir ve DMA ile
+   sirayla gonderilir. false = kuyruk dolu veya gecersiz parametre */
 bool UART_SendToCamera(const uint8_t *data, uint16_t len);
 bool UART_SendToControl(const uint8_t *data, uint16_t len);
 
-/* Yardim: icte kullanilan packet islemleri icin cagirilir */
+/* Sabit frame gonderimi (kopyasiz): data gonderim bitene kadar gecerli kalmali
+   (flash'taki const tablolar). Slot boyu siniri yoktur. */
+bool UART_SendToCameraStatic(const uint8_t *data, uint16_t len);
+bool UART_SendToControlStatic(const uint8_t *data, uint16_t len);
+
+/* Gonderim tamamlandi callback'i (NULL ile kaldirilir) */
+void UART_RegisterTxCompleteCallback(UartPort_t port, UartTxCompleteCb_t cb);
+
+/* Kuyrukta bekleyen + gonderilmekte olan frame sayisi */
+uint32_t UART_GetTxQueueDepth(UartPort_t port);
+/* Acilistan beri gorulen en yuksek kuyruk derinligi */
+uint32_t UART_GetTxQueuePeak(UartPort_t port);
+/* Kuyruk dolu oldugu icin reddedilen frame sayisi */
+uint32_t UART_GetTxDropCount(UartPort_t port);
+
+/* UART_Handler_Process tarafindan her tam frame icin, framer'in dogruladigi
+   gorunumle cagirilir */
+void UART_HandleControlFrame(const CtrlPacketView_t *view);
+void UART_HandleCameraFrame(const CamPacketView_t *view);
+
+/* Yardim: framer disindan gelen ham frame'i dogrulayip yukaridakilere verir */
 void UART_HandleControlPacket(const uint8_t *pkt, uint16_t len);
 void UART_HandleCameraPacket(const uint8_t *pkt, uint16_t len);
 
@@ -0,0 +1,512 @@
+/**
+ * @file cam_scheduler.c
+ * @brief Kamera tarafi gonderim penceresi (kredi tabanli akis kontrolu)
+ *
+ * Yoldaki komut sayisi bekleyen komut listesinin boyudur
+ * (CommandHandler_GetPendingCount): yanit eslendiginde ya da timeout
+ * oldugunda kayit silinir, kredi kendiliginden geri doner. Ayri bir sayac
+ * tutulmadigi icin kaybolan yanit krediyi kalici olarak tuketmez.
+ *
+ * Sira elemanlari tek havuzda (sched_items) durur; her oncelik sinifinin
+ * kendi FIFO'su havuz indekslerini tutar. Toplam eleman CAM_SCHED_QUEUE_DEPTH'i
+ * gecmedigi icin sinif FIFO'lari tasmaz.
+ */
+
+#include "cam_scheduler.h"
+#include "command_handler.h"
+#include "translator_dsl.h"   /* TR_CAM_PKT_MAX */
+#include "uart_handler.h"
+#include "main.h"   /* HAL_GetTick */
+#include <string.h>
+
+
+static_assert((CAM_SCHED_QUEUE_DEPTH & (CAM_SCHED_QUEUE_DEPTH - 1U)) == 0U,
+              "CAM_SCHED_QUEUE_DEPTH 2'nin kuvveti olmali");
+static_assert(CAM_SCHED_QUEUE_DEPTH < 256U, "sira indeksi uint8_t'ye sigmali");
+static_assert(CAM_SCHED_WINDOW_MAX <= CMD_BUFFER_SIZE,
+              "pencere bekleyen komut buffer'indan buyuk olamaz");
+static_assert((uint32_t)CMD_PRIO_COUNT == 4U, "sched_weight her sinif icin bir deger tutmali");
+static_assert((CAM_SCHED_WINDOW_DEFAULT >= 1U) && (CAM_SCHED_WINDOW_DEFAULT <= CAM_SCHED_WINDOW_MAX),
+              "CAM_SCHED_WINDOW_DEFAULT 1..CAM_SCHED_WINDOW_MAX olmali");
+
+/* Kredi bekleyen komut: frame + gonderimde eklenecek bekleyen komut kaydi */
+typedef struct {
+    const uint8_t *frame;           /* flash frame, NULL = bytes[] */
+    uint8_t len;
+    uint8_t bytes[TR_CAM_PKT_MAX];
+    uint32_t enqueued;              /* siraya giris (HAL_GetTick) */
+    cmdBlock_t req;
+} cam_sched_item_t;
+
+/* Agirlikli siralamada sinif basina tur hakki (CMD_PRIO_* sirasi) */
+static const uint8_t sched_weight[CMD_PRIO_COUNT] = { 8U, 4U, 2U, 1U };
+
+static cam_sched_item_t sched_items[CAM_SCHED_QUEUE_DEPTH];
+static uint8_t sched_free[CAM_SCHED_QUEUE_DEPTH];           /* bos havuz indeksleri (yigin) */
+static uint8_t sched_free_count;
+static uint8_t sched_fifo[CMD_PRIO_COUNT][CAM_SCHED_QUEUE_DEPTH];
+static uint8_t sched_head[CMD_PRIO_COUNT];  /* serbest sayan indeksler */
+static uint8_t sched_tail[CMD_PRIO_COUNT];
+static uint8_t sched_queued;
+static CamSchedPolicy_t sched_policy;
+static uint8_t sched_wrr_class;     /* agirlikli: sirasi gelen sinif */
+static uint8_t sched_wrr_left;      /* ve kalan hakki */
+static uint8_t sched_window;
+static uint32_t sched_tick;         /* mesgul sure olcumu icin son bakis */
+static CamSchedStats_t sched_stats;
+static CamSchedWindowStats_t sched_window_stats[CAM_SCHED_WINDOW_MAX];
+static CamSchedClassStats_t sched_class_stats[CMD_PRIO_COUNT];
+
+/* Forward declarations for local helpers */
+static bool sched_send(const uint8_t *frame, uint8_t len, bool frame_static, const cmdBlock_t *req_ptr);
+static uint8_t sched_class_of(const cmdBlock_t *req_ptr);
+static void sched_close_reads(const cmdBlock_t *set_req_ptr);
+static bool sched_pick(uint32_t now, uint8_t *cls_ptr);
+static void sched_class_account(uint8_t cls, uint32_t delay_ms);
+static cam_sched_item_t *sched_find_coalescable(const cmdBlock_t *req_ptr);
+static bool sched_attach_read(const cmdBlock_t *req_ptr);
+static void sched_ack_superseded(const cmdBlock_t *req_ptr);
+static void sched_item_store(cam_sched_item_t *item, const uint8_t *frame, uint8_t len, bool frame_static, const cmdBlock_t *req_ptr);
+static void sched_account_busy(void);
+
+
+void CamSched_Init(void)
+{
+    for (uint8_t i = 0U; i < CAM_SCHED_QUEUE_DEPTH; i++) {
+        sched_free[i] = (uint8_t)(CAM_SCHED_QUEUE_DEPTH - 1U - i);
+    }
+    sched_free_count = CAM_SCHED_QUEUE_DEPTH;
+    (void)memset(sched_head, 0, sizeof(sched_head));
+    (void)memset(sched_tail, 0, sizeof(sched_tail));
+    sched_queued = 0U;
+    sched_policy = CAM_SCHED_POLICY_DEFAULT;
+    sched_wrr_class = 0U;
+    sched_wrr_left = sched_weight[0];
+    sched_window = CAM_SCHED_WINDOW_DEFAULT;
+    sched_tick = HAL_GetTick();
+    CamSched_ResetStats();
+}
+
+bool CamSched_SetWindow(uint8_t window)
+{
+    if ((window == 0U) || (window > CAM_SCHED_WINDOW_MAX)) {
+        return false;
+    }
+
+    /* Gecen sure eski boya yazilsin */
+    sched_account_busy();
+    sched_window = window;
+    return true;
+}
+
+uint8_t CamSched_GetWindow(void)
+{
+    return sched_window;
+}
+
+uint8_t CamSched_GetCredits(void)
+{
+    const uint32_t in_flight = CommandHandler_GetPendingCount();
+
+    return (in_flight < sched_window) ? (uint8_t)(sched_window - in_flight) : 0U;
+}
+
+uint8_t CamSched_GetQueued(void)
+{
+    return sched_queued;
+}
+
+uint8_t CamSched_GetQueuedClass(cmdPriority_t cls)
+{
+    if ((uint32_t)cls >= (uint32_t)CMD_PRIO_COUNT) {
+        return 0U;
+    }
+    return (uint8_t)(sched_head[cls] - sched_tail[cls]);
+}
+
+bool CamSched_SetPolicy(CamSchedPolicy_t policy)
+{
+    if ((policy != CAM_SCHED_POLICY_STRICT) && (policy != CAM_SCHED_POLICY_WEIGHTED)) {
+        return false;
+    }
+    sched_policy = policy;
+    sched_wrr_class = 0U;
+    sched_wrr_left = sched_weight[0];
+    return true;
+}
+
+CamSchedPolicy_t CamSched_GetPolicy(void)
+{
+    return sched_policy;
+}
+
+bool CamSched_Submit(const uint8_t *frame, uint8_t len, bool frame_static, const cmdBlock_t *req_ptr)
+{
+    cam_sched_item_t *item;
+    uint8_t cls;
+    uint8_t idx;
+
+    if ((frame == NULL) || (req_ptr == NULL) || (len == 0U) || (len > TR_CAM_PKT_MAX)) {
+        return false;
+    }
+    sched_stats.submitted++;
+
+    /* Ayni sorgunun okumasi yolda / sirada: bekleyen olarak eklenir */
+    if (sched_attach_read(req_ptr)) {
+        sched_stats.read_waiters++;
+        return true;
+    }
+
+    /* Set: oncesindeki ayni parametre okumalarina yeni okuma eklenmez */
+    if (req_ptr->shape == (uint8_t)CMD_RESP_SHAPE_ACK) {
+        sched_close_reads(req_ptr);
+    }
+
+    /* Ayni parametreye sirada bekleyen set: yenisi yerine gecer, eskisi ACK'lenir */
+    item = sched_find_coalescable(req_ptr);
+    if (item != NULL) {
+        sched_ack_superseded(&item->req);
+        sched_item_store(item, frame, len, frame_static, req_ptr);
+        sched_stats.coalesced++;
+        return true;
+    }
+
+    /* Hicbir sinifta bekleyen yoksa ve kredi varsa beklemeden (kopyasiz)
+       gonder; biri bekliyorsa yeni komut onu sinif sirasina gore gecer */
+    cls = sched_class_of(req_ptr);
+    if ((sched_queued == 0U) && (CamSched_GetCredits() != 0U)) {
+        if (sched_send(frame, len, frame_static, req_ptr)) {
+            sched_class_account(cls, 0U);
+            return true;
+        }
+    }
+
+    if (sched_free_count == 0U) {
+        sched_stats.dropped++;
+        return false;
+    }
+
+    /* Kredi yok (ya da TX kuyrugu dolu): sinifinin sirasinda bekler,
+       uretilen frame kopyalanir */
+    idx = sched_free[--sched_free_count];
+    item = &sched_items[idx];
+    sched_item_store(item, frame, len, frame_static, req_ptr);
+    item->enqueued = HAL_GetTick();
+    sched_fifo[cls][sched_head[cls] & (CAM_SCHED_QUEUE_DEPTH - 1U)] = idx;
+    sched_head[cls]++;
+    sched_queued++;
+
+    sched_stats.deferred++;
+    if (sched_queued > sched_stats.queue_peak) {
+        sched_stats.queue_peak = sched_queued;
+    }
+    return true;
+}
+
+void CamSched_Process(void)
+{
+    const cam_sched_item_t *item;
+    uint32_t now;
+    uint8_t cls;
+    uint8_t idx;
+
+    sched_account_busy();
+
+    now = HAL_GetTick();
+    while ((CamSched_GetCredits() != 0U) && sched_pick(now, &cls)) {
+        idx = sched_fifo[cls][sched_tail[cls] & (CAM_SCHED_QUEUE_DEPTH - 1U)];
+        item = &sched_items[idx];
+        if (item->frame != NULL) {
+            if (!sched_send(item->frame, item->len, true, &item->req)) {
+                break;      /* TX kuyrugu dolu: sonraki turda */
+            }
+        } else if (!sched_send(item->bytes, item->len, false, &item->req)) {
+            break;
+        }
+        sched_class_account(cls, now - item->enqueued);
+        if ((cls == sched_wrr_class) && (sched_wrr_left != 0U)) {
+            sched_wrr_left--;
+        }
+        sched_tail[cls]++;
+        sched_queued--;
+        sched_free[sched_free_count++] = idx;
+    }
+}
+
+void CamSched_OnResponse(void)
+{
+    sched_window_stats[sched_window - 1U].responses++;
+}
+
+void CamSched_OnTimeouts(uint8_t count)
+{
+    sched_window_stats[sched_window - 1U].timeouts += count;
+}
+
+void CamSched_GetStats(CamSchedStats_t *out)
+{
+    if (out != NULL) {
+        *out = sched_stats;
+    }
+}
+
+void CamSched_GetClassStats(cmdPriority_t cls, CamSchedClassStats_t *out)
+{
+    if (out == NULL) {
+        return;
+    }
+    if ((uint32_t)cls >= (uint32_t)CMD_PRIO_COUNT) {
+        (void)memset(out, 0, sizeof(*out));
+        return;
+    }
+    *out = sched_class_stats[cls];
+}
+
+void CamSched_GetWindowStats(uint8_t window, CamSchedWindowStats_t *out)
+{
+    if (out == NULL) {
+        return;
+    }
+    if ((window == 0U) || (window > CAM_SCHED_WINDOW_MAX)) {
+        (void)memset(out, 0, sizeof(*out));
+        return;
+    }
+    sched_account_busy();
+    *out = sched_window_stats[window - 1U];
+}
+
+uint32_t CamSched_GetThroughput(uint8_t window)
+{
+    CamSchedWindowStats_t ws;
+
+    CamSched_GetWindowStats(window, &ws);
+    if (ws.busy_ms == 0U) {
+        return 0U;
+    }
+    return (uint32_t)(((uint64_t)ws.responses * 1000U) / ws.busy_ms);
+}
+
+void CamSched_ResetStats(void)
+{
+    (void)memset(&sched_stats, 0, sizeof(sched_stats));
+    (void)memset(sched_window_stats, 0, sizeof(sched_window_stats));
+    (void)memset(sched_class_stats, 0, sizeof(sched_class_stats));
+    sched_tick = HAL_GetTick();
+}
+
+
+/* Frame'i kameraya ver; kabul edilirse bekleyen komut olarak kaydet.
+   Yanit ana dongude islendiginden kayit, yanit gelmeden once eklenmis olur. */
+static bool sched_send(const uint8_t *frame, uint8_t len, bool frame_static, const cmdBlock_t *req_ptr)
+{
+    uint32_t in_flight;
+    bool ok;
+
+    ok = frame_static ? UART_SendToCameraStatic(frame, (uint16_t)len)
+                      : UART_SendToCamera(frame, (uint16_t)len);
+    if (!ok) {
+        return false;
+    }
+
+    /* Kredi kontrol edildi: pencere <= CMD_BUFFER_SIZE oldugundan yer vardir */
+    (void)CommandHandler_CommitSent(req_ptr);
+    sched_window_stats[sched_window - 1U].sent++;
+
+    in_flight = CommandHandler_GetPendingCount();
+    if (in_flight > sched_stats.in_flight_peak) {
+        sched_stats.in_flight_peak = (uint8_t)in_flight;
+    }
+    return true;
+}
+
+/* Sirada bekleyen, ayni parametreyi (query_id + B1 B2 B3) ayarlayan set */
+static cam_sched_item_t *sched_find_coalescable(const cmdBlock_t *req_ptr)
+{
+    cam_sched_item_t *item;
+
+    if (req_ptr->coalesce == 0U) {
+        return NULL;
+    }
+    for (uint8_t cls = 0U; cls < (uint8_t)CMD_PRIO_COUNT; cls++) {
+        for (uint8_t i = sched_tail[cls]; i != sched_head[cls]; i++) {
+            item = &sched_items[sched_fifo[cls][i & (CAM_SCHED_QUEUE_DEPTH - 1U)]];
+            if ((item->req.coalesce != 0U) && (item->req.nmbr == req_ptr->nmbr) &&
+                (memcmp(item->req.cam_cmd, req_ptr->cam_cmd, sizeof(req_ptr->cam_cmd)) == 0)) {
+                return item;
+            }
+        }
+    }
+    return NULL;
+}
+
+/* Tek ucus: once yoldaki okuma (bit maskesi), yoksa siradaki ayni sorgu */
+static bool sched_attach_read(const cmdBlock_t *req_ptr)
+{
+    cam_sched_item_t *item;
+
+    if ((req_ptr->shape != (uint8_t)CMD_RESP_SHAPE_DATA) || (req_ptr->nmbr == QUERY_NONE)) {
+        return false;
+    }
+    if (CommandHandler_AttachReadWaiter(req_ptr)) {
+        return true;
+    }
+    for (uint8_t cls = 0U; cls < (uint8_t)CMD_PRIO_COUNT; cls++) {
+        for (uint8_t i = sched_tail[cls]; i != sched_head[cls]; i++) {
+            item = &sched_items[sched_fifo[cls][i & (CAM_SCHED_QUEUE_DEPTH - 1U)]];
+            if ((item->req.shape == (uint8_t)CMD_RESP_SHAPE_DATA) && (item->req.nmbr == req_ptr->nmbr) &&
+                (item->req.joinable != 0U) && (item->req.waiters < CMD_READ_WAITERS_MAX)) {
+                item->req.waiters++;
+                return true;
+            }
+        }
+    }
+    return false;
+}
+
+/* Kameraya gitmeyecek istegin kontrol yaniti */
+static void sched_ack_superseded(const cmdBlock_t *req_ptr)
+{
+    uint8_t ctrl_resp[64];
+    const uint8_t *ctrl_frame = NULL;
+    uint8_t ctrl_len = 0U;
+
+    if (CommandHandler_RespondSuperseded(req_ptr, ctrl_resp, &ctrl_frame, &ctrl_len) != TRANSLATION_OK) {
+        return;
+    }
+    if (ctrl_frame != ctrl_resp) {
+        (void)UART_SendToControlStatic(ctrl_frame, (uint16_t)ctrl_len);
+    } else {
+        (void)UART_SendToControl(ctrl_resp, (uint16_t)ctrl_len);
+    }
+}
+
+/* Sira elemanina frame ve kaydi yaz (uretilen frame kopyalanir) */
+static void sched_item_store(cam_sched_item_t *item, const uint8_t *frame, uint8_t len, bool frame_static, const cmdBlock_t *req_ptr)
+{
+    item->len = len;
+    if (frame_static) {
+        item->frame = frame;
+    } else {
+        item->frame = NULL;
+        (void)memcpy(item->bytes, frame, len);
+    }
+    item->req = *req_ptr;
+}
+
+/* Komutun sinifi; tanimsiz deger en dusuk sinifa duser. Sirada ayni
+   parametreye set bekliyorsa okuma onun sinifina girer: sinif icinde gelis
+   sirasi korundugundan okuma set'ten once gonderilmez */
+static uint8_t sched_class_of(const cmdBlock_t *req_ptr)
+{
+    const cam_sched_item_t *item;
+    uint8_t cls = (req_ptr->prio < (uint8_t)CMD_PRIO_COUNT) ? req_ptr->prio : (uint8_t)CMD_PRIO_POLL;
+
+    if (req_ptr->shape != (uint8_t)CMD_RESP_SHAPE_DATA) {
+        return cls;
+    }
+    for (uint8_t c = 0U; c < cls; c++) {
+        for (uint8_t i = sched_tail[c]; i != sched_head[c]; i++) {
+            item = &sched_items[sched_fifo[c][i & (CAM_SCHED_QUEUE_DEPTH - 1U)]];
+            if ((item->req.shape == (uint8_t)CMD_RESP_SHAPE_ACK) && CmdBlock_SameParam(&item->req, req_ptr)) {
+                return c;
+            }
+        }
+    }
+    return cls;
+}
+
+/* Yeni set: yoldaki ve siradaki ayni parametre okumalari kapanir */
+static void sched_close_reads(const cmdBlock_t *set_req_ptr)
+{
+    cam_sched_item_t *item;
+
+    CommandHandler_CloseReads(set_req_ptr);
+    for (uint8_t cls = 0U; cls < (uint8_t)CMD_PRIO_COUNT; cls++) {
+        for (uint8_t i = sched_tail[cls]; i != sched_head[cls]; i++) {
+            item = &sched_items[sched_fifo[cls][i & (CAM_SCHED_QUEUE_DEPTH - 1U)]];
+            if ((item->req.shape == (uint8_t)CMD_RESP_SHAPE_DATA) && CmdBlock_SameParam(&item->req, set_req_ptr)) {
+                item->req.joinable = 0U;
+            }
+        }
+    }
+}
+
+/* Siradaki sinifi sec. Bas elemani CAM_SCHED_STARVE_MS'den uzun bekleyen
+   sinif varsa en uzun bekleyen one alinir (aclik korumasi); yoksa kesin
+   oncelikte ilk dolu sinif, agirlikli siralamada hakki kalan sinif */
+static bool sched_pick(uint32_t now, uint8_t *cls_ptr)
+{
+    uint32_t wait;
+    uint32_t oldest = 0U;
+    uint8_t starved = (uint8_t)CMD_PRIO_COUNT;
+    uint8_t cls;
+
+    if (sched_queued == 0U) {
+        return false;
+    }
+
+    for (cls = 0U; cls < (uint8_t)CMD_PRIO_COUNT; cls++) {
+        if (sched_head[cls] == sched_tail[cls]) {
+            continue;
+        }
+        wait = now - sched_items[sched_fifo[cls][sched_tail[cls] & (CAM_SCHED_QUEUE_DEPTH - 1U)]].enqueued;
+        if ((wait >= CAM_SCHED_STARVE_MS) && (wait > oldest)) {
+            oldest = wait;
+            starved = cls;
+        }
+    }
+    if (starved < (uint8_t)CMD_PRIO_COUNT) {
+        /* Ustteki dolu bir sinifin onune gectiyse one alma sayilir */
+        for (cls = 0U; cls < starved; cls++) {
+            if (sched_head[cls] != sched_tail[cls]) {
+                sched_class_stats[starved].promoted++;
+                break;
+            }
+        }
+        *cls_ptr = starved;
+        return true;
+    }
+
+    if (sched_policy == CAM_SCHED_POLICY_STRICT) {
+        for (cls = 0U; sched_head[cls] == sched_tail[cls]; cls++) {
+        }
+        *cls_ptr = cls;
+        return true;
+    }
+
+    /* Agirlikli: sinif hakki bitince ya da sirasi bossa sonrakine gec */
+    for (uint8_t n = 0U; n <= (uint8_t)CMD_PRIO_COUNT; n++) {
+        if ((sched_wrr_left != 0U) && (sched_head[sched_wrr_class] != sched_tail[sched_wrr_class])) {
+            *cls_ptr = sched_wrr_class;
+            return true;
+        }
+        sched_wrr_class = (uint8_t)((sched_wrr_class + 1U) % (uint8_t)CMD_PRIO_COUNT);
+        sched_wrr_left = sched_weight[sched_wrr_class];
+    }
+    return false;
+}
+
+/* Sinif basina gonderim ve siradaki bekleme suresi */
+static void sched_class_account(uint8_t cls, uint32_t delay_ms)
+{
+    CamSchedClassStats_t *cs = &sched_class_stats[cls];
+
+    cs->sent++;
+    cs->delay_sum_ms += delay_ms;
+    if (delay_ms > cs->delay_max_ms) {
+        cs->delay_max_ms = delay_ms;
+    }
+}
+
+/* Sirada ya da yolda komut varken gecen sureyi etkin pencere boyuna yaz */
+static void sched_account_busy(void)
+{
+    const uint32_t now = HAL_GetTick();
+
+    if ((sched_queued != 0U) || (CommandHandler_GetPendingCount() != 0U)) {
+        sched_window_stats[sched_window - 1U].busy_ms += now - sched_tick;
+    }
+    sched_tick = now;
+}
+
+/* End of file */
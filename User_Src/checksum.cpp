@@ -0,0 +1,231 @@
+/**
+ * @file checksum.c
+ * @brief Kelime bazli checksum cekirdekleri ve olcum
+ *
+ * Toplam mod 256 oldugundan ara toplamlarin tasmasi sadece 256'nin katlari
+ * kadar fark yaratir; seritli (lane) toplamalar bu yuzden periyodik olarak
+ * 32 bit toplama bosaltilir ve en sonda alt byte alinir.
+ */
+
+#include "checksum.h"
+#include <string.h>
+
+#if (CHECKSUM_KERNEL == CHECKSUM_KERNEL_DSP)
+#include "main.h"       /* CMSIS: __USADA8, DWT */
+#elif (CHECKSUM_KERNEL == CHECKSUM_KERNEL_SSE2)
+#include <emmintrin.h>
+#elif (CHECKSUM_KERNEL == CHECKSUM_KERNEL_NEON)
+#include <arm_neon.h>
+#endif
+
+#ifndef CHECKSUM_CYCLE_STATS
+#define CHECKSUM_CYCLE_STATS 0
+#endif
+
+/* Hizasiz 32 bit okuma (M4'te tek LDR) */
+static inline uint32_t load_u32(const uint8_t *p)
+{
+    uint32_t w;
+
+    (void)memcpy(&w, p, sizeof(w));
+    return w;
+}
+
+uint8_t Checksum_Sum8(const uint8_t *data_ptr, uint32_t len)
+{
+    uint32_t sum = 0U;
+    uint32_t i = 0U;
+
+#if (CHECKSUM_KERNEL == CHECKSUM_KERNEL_DSP)
+    /* USADA8(w, 0, acc) = acc + |b0| + |b1| + |b2| + |b3|: 4 byte / komut */
+    for (; (i + 8U) <= len; i += 8U) {
+        sum = __USADA8(load_u32(&data_ptr[i]), 0U, sum);
+        sum = __USADA8(load_u32(&data_ptr[i + 4U]), 0U, sum);
+    }
+    if ((i + 4U) <= len) {
+        sum = __USADA8(load_u32(&data_ptr[i]), 0U, sum);
+        i += 4U;
+    }
+#elif (CHECKSUM_KERNEL == CHECKSUM_KERNEL_SSE2)
+    const __m128i zero = _mm_setzero_si128();
+    __m128i acc = zero;
+
+    /* SAD(v, 0): 8 byte'lik iki yarinin toplami, 64 bit seritlerde */
+    for (; (i + 16U) <= len; i += 16U) {
+        const __m128i v = _mm_loadu_si128((const __m128i *)(const void *)&data_ptr[i]);
+        acc = _mm_add_epi64(acc, _mm_sad_epu8(v, zero));
+    }
+    sum = (uint32_t)_mm_cvtsi128_si32(acc) + (uint32_t)_mm_cvtsi128_si32(_mm_srli_si128(acc, 8));
+#elif (CHECKSUM_KERNEL == CHECKSUM_KERNEL_NEON)
+    uint16x8_t acc = vdupq_n_u16(0U);
+    uint32_t blocks = 0U;
+
+    /* 16 bit seritte 2 byte / tur: 128 turda bir bosalt (128 * 510 < 65536) */
+    for (; (i + 16U) <= len; i += 16U) {
+        acc = vpadalq_u8(acc, vld1q_u8(&data_ptr[i]));
+        if (++blocks == 128U) {
+            const uint64x2_t s = vpaddlq_u32(vpaddlq_u16(acc));
+            sum += (uint32_t)(vgetq_lane_u64(s, 0) + vgetq_lane_u64(s, 1));
+            acc = vdupq_n_u16(0U);
+            blocks = 0U;
+        }
+    }
+    {
+        const uint64x2_t s = vpaddlq_u32(vpaddlq_u16(acc));
+        sum += (uint32_t)(vgetq_lane_u64(s, 0) + vgetq_lane_u64(s, 1));
+    }
+#else
+    uint32_t acc = 0U;
+    uint32_t words = 0U;
+
+    /* SWAR: cift/tek bytelar iki 16 bit seride, 128 kelimede bir bosalt */
+    for (; (i + 4U) <= len; i += 4U) {
+        const uint32_t w = load_u32(&data_ptr[i]);
+        acc += (w & 0x00FF00FFUL) + ((w >> 8) & 0x00FF00FFUL);
+        if (++words == 128U) {
+            sum += (acc & 0xFFFFU) + (acc >> 16);
+            acc = 0U;
+            words = 0U;
+        }
+    }
+    sum += (acc & 0xFFFFU) + (acc >> 16);
+#endif
+
+    for (; i < len; i++) {
+        sum += data_ptr[i];
+    }
+    return (uint8_t)(sum & 0xFFU);
+}
+
+uint8_t Checksum_Xor8(const uint8_t *data_ptr, uint32_t len)
+{
+    uint32_t x = 0U;
+    uint32_t i = 0U;
+
+#if (CHECKSUM_KERNEL == CHECKSUM_KERNEL_SSE2)
+    __m128i acc = _mm_setzero_si128();
+
+    for (; (i + 16U) <= len; i += 16U) {
+        acc = _mm_xor_si128(acc, _mm_loadu_si128((const __m128i *)(const void *)&data_ptr[i]));
+    }
+    acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 8));
+    acc = _mm_xor_si128(acc, _mm_srli_si128(acc, 4));
+    x = (uint32_t)_mm_cvtsi128_si32(acc);
+#elif (CHECKSUM_KERNEL == CHECKSUM_KERNEL_NEON)
+    uint8x16_t acc = vdupq_n_u8(0U);
+
+    for (; (i + 16U) <= len; i += 16U) {
+        acc = veorq_u8(acc, vld1q_u8(&data_ptr[i]));
+    }
+    {
+        const uint64x2_t a = vreinterpretq_u64_u8(acc);
+        const uint64_t h = vgetq_lane_u64(a, 0) ^ vgetq_lane_u64(a, 1);
+        x = (uint32_t)h ^ (uint32_t)(h >> 32);
+    }
+#else
+    /* DSP ve genel yol: 32 bit kelime XOR'u, 2 kelime / tur */
+    for (; (i + 8U) <= len; i += 8U) {
+        x ^= load_u32(&data_ptr[i]) ^ load_u32(&data_ptr[i + 4U]);
+    }
+    if ((i + 4U) <= len) {
+        x ^= load_u32(&data_ptr[i]);
+        i += 4U;
+    }
+#endif
+
+    /* 4 byte'lik seritleri tek byte'a katla */
+    x ^= x >> 16;
+    x ^= x >> 8;
+    for (; i < len; i++) {
+        x ^= data_ptr[i];
+    }
+    return (uint8_t)(x & 0xFFU);
+}
+
+const char *Checksum_KernelName(void)
+{
+#if (CHECKSUM_KERNEL == CHECKSUM_KERNEL_DSP)
+    return "dsp";
+#elif (CHECKSUM_KERNEL == CHECKSUM_KERNEL_SSE2)
+    return "sse2";
+#elif (CHECKSUM_KERNEL == CHECKSUM_KERNEL_NEON)
+    return "neon";
+#else
+    return "generic";
+#endif
+}
+
+#if (CHECKSUM_CYCLE_STATS == 1) && (CHECKSUM_KERNEL == CHECKSUM_KERNEL_DSP)
+/* Cekirdeklerden onceki byte byte donguler (karsilastirma icin aynen) */
+static uint8_t __attribute__((noinline)) sum_loop(const uint8_t *p, uint32_t len)
+{
+    uint32_t sum = 0U;
+
+    for (uint32_t i = 0U; i < len; i++) {
+        sum += (uint32_t)p[i];
+    }
+    return (uint8_t)(sum % 256U);
+}
+
+static uint8_t __attribute__((noinline)) xor_loop(const uint8_t *p, uint32_t len)
+{
+    uint8_t xorv = 0U;
+
+    for (uint32_t i = 0U; i < len; i++) {
+        xorv ^= p[i];
+    }
+    return xorv;
+}
+
+uint8_t Checksum_Benchmark(ChecksumBench_t *out, const uint16_t *lens, uint8_t lens_count, uint16_t iterations)
+{
+    static uint8_t buf[256 + 3];
+    uint8_t rows = 0U;
+
+    if ((out == NULL) || (lens == NULL) || (iterations == 0U)) {
+        return 0U;
+    }
+
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    for (uint32_t i = 0U; i < sizeof(buf); i++) {
+        buf[i] = (uint8_t)((i * 37U) + 11U);
+    }
+
+    for (uint8_t r = 0U; r < lens_count; r++) {
+        /* Frame'ler halkada hizasiz durur: +1 ofsetle olc */
+        const uint8_t *p = &buf[1];
+        const uint16_t len = (lens[r] > 256U) ? 256U : lens[r];
+        volatile uint8_t sink = 0U;
+        uint32_t t[4] = { 0U, 0U, 0U, 0U };
+        uint32_t start;
+
+        for (uint16_t k = 0U; k < iterations; k++) {
+            start = DWT->CYCCNT;
+            sink = sum_loop(p, len);
+            t[0] += DWT->CYCCNT - start;
+            start = DWT->CYCCNT;
+            sink = Checksum_Sum8(p, len);
+            t[1] += DWT->CYCCNT - start;
+            start = DWT->CYCCNT;
+            sink = xor_loop(p, len);
+            t[2] += DWT->CYCCNT - start;
+            start = DWT->CYCCNT;
+            sink = Checksum_Xor8(p, len);
+            t[3] += DWT->CYCCNT - start;
+        }
+        (void)sink;
+
+        out[rows].len = len;
+        out[rows].sum_loop_cycles = t[0] / iterations;
+        out[rows].sum_kernel_cycles = t[1] / iterations;
+        out[rows].xor_loop_cycles = t[2] / iterations;
+        out[rows].xor_kernel_cycles = t[3] / iterations;
+        out[rows].results_match = (sum_loop(p, len) == Checksum_Sum8(p, len)) &&
+                                  (xor_loop(p, len) == Checksum_Xor8(p, len));
+        rows++;
+    }
+    return rows;
+}
+#endif
@@ -12,153 +12,344 @@
 
 #include "command_handler.h"
 #include "command_tracking.h"
+#include "translator_dsl.h"
+#include "commands_metadata.h"
+#include "checksum.h"
+#include "../Application/zoom_adtr_commands.h"   /* arrayForZoom */
 #include "main.h"      /* HAL_GetTick */
 #include <string.h>
 
 
-#define CONSTANT_PL_FOR_CALC_CS  9 // -> 9 byte yanıt paket uzunluğu
 /* Bekleyen komutlar buffer'i */
 static cmdRingBuffer_t g_pending_commands;
 
-///* Forward declare translator/response functions (implemented below) */
-static bool Translator_SimpleSet(
-    const uint8_t *ctrl_packet_ptr, uint8_t ctrl_len,
-    uint8_t *cam_packet_ptr, uint8_t *cam_len_ptr);
-
-static bool Translator_ZoomSet(
-    const uint8_t *ctrl_packet_ptr, uint8_t ctrl_len,
-    uint8_t *cam_packet_ptr, uint8_t *cam_len_ptr);
-
-static bool Translator_ReadQuery(
-    const uint8_t *ctrl_packet_ptr, uint8_t ctrl_len,
-    uint8_t *cam_packet_ptr, uint8_t *cam_len_ptr);
-
+/* Ceviri memo cache'i: dogrulanmis kontrol frame'i -> bitmis kamera frame'i.
+   Tam iliskili, en uzun suredir kullanilmayan kayit cikarilir. Ceviri kontrol
+   bytelarinin saf fonksiyonu oldugundan (tablolar acilistan sonra sabit)
+   gecersiz kilma sadece CommandHandler_Init'te yapilir. */
+typedef struct {
+    uint32_t hash;                          /* 0 = bos kayit */
+    uint32_t stamp;                         /* son kullanim (LRU) */
+    const CommandMapping_t *mapping;
+    const uint8_t *frame;                   /* hazir flash frame, NULL = cam[] */
+    queryBitEnum query_id;
+    uint8_t prio;                           /* cmdPriority_t */
+    uint8_t coalesce;
+    uint8_t ctrl_len;
+    uint8_t cam_len;
+    uint8_t ctrl[CMD_MEMO_CTRL_MAX];        /* carpisma kontrolu icin tam frame */
+    uint8_t cam[TR_CAM_PKT_MAX];
+} CmdMemoEntry_t;
+
+static CmdMemoEntry_t g_memo[CMD_MEMO_ENTRIES];
+static uint32_t g_memo_clock;
+static CmdMemoStats_t g_memo_stats;
+
+/* Yanit eslestirme sayaclari (cmdMatchKind_t basina) */
+static CmdMatchStats_t g_match_stats;
+
+///* Forward declare response functions (implemented below) */
 static bool ResponseGen_SimpleACK(
-    const uint8_t *cam_resp_ptr, uint8_t cam_len,
-    const uint8_t *orig_ctrl_ptr, uint8_t orig_ctrl_len,
+    const CamPacketView_t *cam_view_ptr,
+    const cmdBlock_t *pending_ptr,
     uint8_t *ctrl_resp_ptr, uint8_t *ctrl_resp_len_ptr);
 
 static bool ResponseGen_EchoParam(
-    const uint8_t *cam_resp_ptr, uint8_t cam_len,
-    const uint8_t *orig_ctrl_ptr, uint8_t orig_ctrl_len,
+    const CamPacketView_t *cam_view_ptr,
+    const cmdBlock_t *pending_ptr,
     uint8_t *ctrl_resp_ptr, uint8_t *ctrl_resp_len_ptr);
 
 static bool ResponseGen_MultiParam(
-    const uint8_t *cam_resp_ptr, uint8_t cam_len,
-    const uint8_t *orig_ctrl_ptr, uint8_t orig_ctrl_len,
+    const CamPacketView_t *cam_view_ptr,
+    const cmdBlock_t *pending_ptr,
     uint8_t *ctrl_resp_ptr, uint8_t *ctrl_resp_len_ptr);
 
+/* Flash tablosu komutlari icin yanit secimi (CmdTabResp_t ile indekslenir).
+   Pending kayit mapping olarak bunu tutar; sadece response_gen kullanilir.
+   Sinif ve birlestirme tablo kaydindan gelir (CmdTabCommand_t), prio burada
+   kullanilmaz. */
+static const CommandMapping_t cmdtab_resp_map[CMDTAB_RESP_COUNT] = {
+    { 0U, QUERY_NONE, CMD_TYPE_SET, {0x00, 0x00, 0x00}, NULL, ResponseGen_SimpleACK,  "cmdtab ACK", NULL, CMD_PRIO_INTERACTIVE },
+    { 0U, QUERY_NONE, CMD_TYPE_SET, {0x00, 0x00, 0x00}, NULL, ResponseGen_EchoParam,  "cmdtab ECHO", NULL, CMD_PRIO_INTERACTIVE },
+    { 0U, QUERY_NONE, CMD_TYPE_SET, {0x00, 0x00, 0x00}, NULL, ResponseGen_MultiParam, "cmdtab MULTI", NULL, CMD_PRIO_INTERACTIVE },
+};
+
+/* ---- Onceden hazirlanmis kamera frame'leri (derleme aninda, flash) ----
+ * Payload'u sonlu kumeden gelen set komutlari. Her (komut, deger) icin tam
+ * frame hazir; ceviri = secici arama + flash pointer'inin DMA ile gonderimi.
+ */
+#define CAM_SET_PAYLOAD_LEN     (4U)    /* 00 00 00 [deger] */
+
+/* Manuel NUC: payload yok, tek frame */
+static constexpr TrFrameTable<1U, 0U, CAM_SET_PAYLOAD_LEN> BuildNucFrames(void)
+{
+    TrFrameTable<1U, 0U, CAM_SET_PAYLOAD_LEN> t = {};
+    const uint8_t pl[CAM_SET_PAYLOAD_LEN] = { 0x00, 0x00, 0x00, 0x01 };
+    TrFrameRender(t, 0U, 0x02, 0x01, 0x08, pl);
+    return t;
+}
+
+/* arrayForZoom: sondaki bos (zoom_pl_new == 0) satirlar haric adim sayisi */
+static constexpr uint8_t ZoomStepCount(void)
+{
+    uint8_t n = 0U;
+    while ((n < arrayForZoom.size()) && (arrayForZoom[n].zoom_pl_new != 0U)) {
+        n++;
+    }
+    return n;
+}
+#define ZOOM_OLD_PL_LEN     (9U)
+
+/* Zoom: kontrol payload'u (9 byte, eski protokol) -> kamera degeri */
+static constexpr TrFrameTable<ZoomStepCount(), ZOOM_OLD_PL_LEN, CAM_SET_PAYLOAD_LEN> BuildZoomFrames(void)
+{
+    TrFrameTable<ZoomStepCount(), ZOOM_OLD_PL_LEN, CAM_SET_PAYLOAD_LEN> t = {};
+    for (uint8_t i = 0U; i < ZoomStepCount(); i++) {
+        const uint8_t pl[CAM_SET_PAYLOAD_LEN] = { 0x00, 0x00, 0x00, arrayForZoom[i].zoom_pl_new };
+        for (uint8_t k = 0U; k < ZOOM_OLD_PL_LEN; k++) {
+            t.keys[i][k] = arrayForZoom[i].zoom_pl_old[k];
+        }
+        TrFrameRender(t, i, 0x02, 0x00, 0x06, pl);
+    }
+    return t;
+}
+
+static constexpr auto nuc_frames = BuildNucFrames();
+static constexpr auto zoom_frames = BuildZoomFrames();
+
+static_assert(TrFrameKeysSorted(zoom_frames), "arrayForZoom zoom_pl_old artan ve tekil olmali");
+
+#define CAM_FRAME_SET(tbl, off) \
+    { (off), (tbl).key_len, (tbl).count, (tbl).frame_len, &(tbl).keys[0][0], &(tbl).frames[0][0] }
+
+static constexpr CamFrameSet_t nuc_frame_set = CAM_FRAME_SET(nuc_frames, 0U);
+static constexpr CamFrameSet_t zoom_frame_set = CAM_FRAME_SET(zoom_frames, 5U);
+
+/* ---- Sabit kontrol yanitlari (derleme aninda, flash) ----
+ * Set ACK'i (55 05 00 CMD 33 01 CS EB AA) sadece CMD byte'ina baglidir. Flash
+ * komut tablosunun anahtarlari derleme aninda bilinmedigi icin tablo 256 CMD
+ * degerinin tamamini tutar (2304 byte); yanit kopyalanmadan DMA ile gider.
+ */
+typedef struct {
+    TrCtrlFrame<1U> cmd[256];
+} CtrlAckTable_t;
+
+static constexpr CtrlAckTable_t BuildCtrlAckTable(void)
+{
+    CtrlAckTable_t t = {};
+    for (uint32_t i = 0U; i < 256U; i++) {
+        t.cmd[i] = TrCtrlAck((uint8_t)i);
+    }
+    return t;
+}
+
+static constexpr CtrlAckTable_t ctrl_ack = BuildCtrlAckTable();
+
+/* Sahada dogrulanmis yanit: Manuel NUC ACK = 55 05 00 16 33 01 A4 EB AA */
+static_assert(ctrl_ack.cmd[0x16].b[6] == 0xA4U, "ACK checksum CalculateCtrlChecksum ile ayni olmali");
 
 /* Example entries from the KB table you provided */
-/* TODO: Bu noktada binary search ile tablo aranacağı için CTRL_KEY 'leri yani araç tarafından
- * gelen komut byte'larının  sıralı bir şekilde lsiteye girilmesi gerekmektedir!!!
+/* command_map[] ctrl_key'e gore artan sirada olmali. Ayni anahtari paylasan
+ * kayitlar ardisik durur: once SET sonra READ, anahtar + tip basina tek kayit.
+ * Sira ve tekrar kontrolleri asagidaki static_assert'lerle derleme aninda
+ * yapilir.
  */
-static const CommandMapping_t command_map[] = {
-    /* ctrl_key,                  query_id,        type,           cam_cmd,         translator,           response_gen,       match_pload_func   desc */
-	{ MAKE_CTRL_KEY(0x00,0x16),  QUERY_NONE, 	CMD_TYPE_READ,	{0x02, 0x01, 0x08},Translator_SimpleSet,ResponseGen_SimpleACK,  nullptr ,"Manuel NUC" },
-    { MAKE_CTRL_KEY(0x00,0x2D),  QUERY_NONE, 	CMD_TYPE_SET,  	{0x02, 0x00, 0x04},Translator_SimpleSet,ResponseGen_SimpleACK,  nullptr,"Image Palette BLCK"},
-	{ MAKE_CTRL_KEY(0x00,0x2D),  QUERY_NONE, 	CMD_TYPE_SET,  	{0x02, 0x00, 0x04},Translator_SimpleSet,ResponseGen_SimpleACK,  nullptr, "Image Palette WHT"},
-	{ MAKE_CTRL_KEY(0x00,0x2D),  QUERY_IMG_PAL, CMD_TYPE_READ,	{0x02, 0x00, 0x04},Translator_SimpleSet,ResponseGen_SimpleACK,  nullptr, "Image Palette RD"},
+static constexpr CommandMapping_t command_map[] = {
+    /* ctrl_key,                  query_id,        type,           cam_cmd,           translator (TrCamCmd<B1,B2,B3, adimlar...>),                  response_gen,          desc,                frames,              prio */
+	{ MAKE_CTRL_KEY(0x00,0x16),  QUERY_NONE, 	CMD_TYPE_SET,	{0x02, 0x01, 0x08},NULL,                                                          ResponseGen_SimpleACK,  "Manuel NUC",        &nuc_frame_set,      CMD_PRIO_TRIGGER },
+	{ MAKE_CTRL_KEY(0x00,0x2A),  QUERY_NONE, 	CMD_TYPE_SET,	{0x02, 0x00, 0x06},NULL,                                                          ResponseGen_SimpleACK,  "Zoom",              &zoom_frame_set,     CMD_PRIO_INTERACTIVE },
+    { MAKE_CTRL_KEY(0x00,0x2D),  QUERY_NONE, 	CMD_TYPE_SET,  	{0x02, 0x00, 0x04},&TrCamCmd<0x02,0x00,0x04, TrConst<0x00,3>, TrCopy<5> >::translate,    ResponseGen_SimpleACK,  "Image Palette",     NULL,                CMD_PRIO_INTERACTIVE },
+	{ MAKE_CTRL_KEY(0x00,0x2D),  QUERY_IMG_PAL, CMD_TYPE_READ,	{0x02, 0x00, 0x80},&TrCamCmd<0x02,0x00,0x80, TrConst<0x00,4> >::translate,               ResponseGen_SimpleACK,  "Image Palette RD",  NULL,                CMD_PRIO_READ },
 
     /* Add remaining commands, keep sorted by ctrl_key */
 };
 #define CMD_MAP_COUNT (sizeof(command_map) / sizeof(command_map[0]))
 
-/* Declare in header as extern; define here */
-const CommandMapping_t *g_cmd_lookup_table[256];
-
-/**
- * @brief Build lookup table from command_map
- *
- * Fills g_cmd_lookup_table with pointers; first come first served on collisions.
+/* ---- Derleme aninda dispatch tablosu ----
+ * Iki seviyeli yogun tablo: row_of_kb0[KB0] -> satir (+1), slot[satir][KB1] ->
+ * anahtar dugumu (+1). 0 = tanimsiz. Dugum, anahtar grubunun SET/READ alt
+ * araliklarini tutar; payload karari bu aralik icinde verilir. Tablo constexpr
+ * olarak uretilir, flash'a yerlesir.
  */
-void CommandHandler_BuildLookup(void)
+
+/* Siralama anahtari: ctrl_key | tip | 256 (CMDTAB'daki CMD_MATCH_ANY ile ayni
+   kodlama). Kesin artan olmasi hem sirayi hem tekrar olmamasini garanti eder. */
+static constexpr uint32_t CmdOrderKey(const CommandMapping_t &m)
 {
-    uint32_t i;
-    uint32_t idx_u32;
-    /* Clear table */
-    for (i = 0U; i < 256U; i++) {
-        g_cmd_lookup_table[i] = (const CommandMapping_t *)0;
+    return ((uint32_t)m.ctrl_key << 16U) |
+           ((uint32_t)m.type << 9U) |
+           256U;
+}
+
+static constexpr bool CmdMapIsSorted(void)
+{
+    for (uint32_t i = 1U; i < CMD_MAP_COUNT; i++) {
+        if (command_map[i - 1U].ctrl_key > command_map[i].ctrl_key) {
+            return false;
+        }
     }
+    return true;
+}
 
-    /* Fill from command_map */
-    for (i = 0U; i < CMD_MAP_COUNT; i++) {
-        idx_u32 = (uint32_t)command_map[i].ctrl_key;
-        if (g_cmd_lookup_table[idx_u32] == (const CommandMapping_t *)0) {
-            g_cmd_lookup_table[idx_u32] = &command_map[i];
-        } else {
-            /* Collision: keep first; translator/matcher should disambiguate if needed */
-            /* Optionally implement a collision list here in future. */
+/* Ayni anahtar + tip iki kayit ayirt edilemez; grup ici sira da burada */
+static constexpr bool CmdMapHasNoDuplicates(void)
+{
+    for (uint32_t i = 1U; i < CMD_MAP_COUNT; i++) {
+        if (CmdOrderKey(command_map[i - 1U]) >= CmdOrderKey(command_map[i])) {
+            return false;
         }
     }
+    return true;
 }
 
-/**
- * @brief Compare keys for binary search
- * @return <0 if a<b, 0 if equal, >0 if a>b
- */
-static int16_t CompareCtrlKey(const void *a, const void *b)
+static constexpr uint32_t CmdDispatchRowCount(void)
+{
+    uint32_t rows = 0U;
+    for (uint32_t i = 0U; i < CMD_MAP_COUNT; i++) {
+        if ((i == 0U) || ((command_map[i - 1U].ctrl_key >> 8U) != (command_map[i].ctrl_key >> 8U))) {
+            rows++;     /* sirali oldugundan yeni KB0 = yeni satir */
+        }
+    }
+    return rows;
+}
+
+static constexpr uint32_t CmdDispatchKeyCount(void)
+{
+    uint32_t keys = 0U;
+    for (uint32_t i = 0U; i < CMD_MAP_COUNT; i++) {
+        if ((i == 0U) || (command_map[i - 1U].ctrl_key != command_map[i].ctrl_key)) {
+            keys++;
+        }
+    }
+    return keys;
+}
+
+static_assert(CMD_MAP_COUNT > 0U, "command_map bos olamaz");
+static_assert(CMD_MAP_COUNT < 255U, "command_map indeksi uint8_t'ye sigmali");
+static_assert(CmdMapIsSorted(), "command_map ctrl_key'e gore artan sirada olmali");
+static_assert(CmdMapHasNoDuplicates(),
+              "anahtar grubu SET/READ, P0 (artan), ANY sirasinda olmali ve tekrar kayit olmamali");
+
+#define CMD_DISPATCH_ROWS  (CmdDispatchRowCount())
+#define CMD_DISPATCH_KEYS  (CmdDispatchKeyCount())
+
+/* Anahtar dugumu: CommandType_t ile indekslenen alt araliklar */
+typedef struct {
+    uint8_t first[2];   /* command_map indeksi */
+    uint8_t count[2];   /* 0 = bu tipte kayit yok */
+} CmdKeyNode_t;
+
+typedef struct {
+    uint8_t row_of_kb0[256];
+    uint8_t slot[CMD_DISPATCH_ROWS][256];
+    CmdKeyNode_t node[CMD_DISPATCH_KEYS];
+} CmdDispatchTable_t;
+
+static constexpr CmdDispatchTable_t CmdBuildDispatch(void)
 {
-    const uint16_t ka = ((const CommandMapping_t *)a)->ctrl_key;
-    const uint16_t kb = ((const CommandMapping_t *)b)->ctrl_key;
-    if (ka < kb) { return -1; }
-    if (ka > kb) { return 1; }
-    return 0;
+    CmdDispatchTable_t t = {};
+    uint8_t row = 0U;
+    uint8_t key = 0U;
+
+    for (uint32_t i = 0U; i < CMD_MAP_COUNT; i++) {
+        const uint8_t kb0 = (uint8_t)(command_map[i].ctrl_key >> 8U);
+        const uint8_t kb1 = (uint8_t)(command_map[i].ctrl_key & 0xFFU);
+        const uint8_t type = (uint8_t)command_map[i].type;
+
+        if (t.row_of_kb0[kb0] == 0U) {
+            row++;
+            t.row_of_kb0[kb0] = row;
+        }
+        /* Grubun ilk kaydi: yeni dugum */
+        if (t.slot[t.row_of_kb0[kb0] - 1U][kb1] == 0U) {
+            key++;
+            t.slot[t.row_of_kb0[kb0] - 1U][kb1] = key;
+        }
+        CmdKeyNode_t &n = t.node[key - 1U];
+        if (n.count[type] == 0U) {
+            n.first[type] = (uint8_t)i;
+        }
+        n.count[type]++;
+    }
+    return t;
+}
+
+static constexpr CmdDispatchTable_t cmd_dispatch = CmdBuildDispatch();
+
+static const CmdKeyNode_t *CmdFindNode(uint16_t key)
+{
+    const uint8_t row = cmd_dispatch.row_of_kb0[key >> 8U];
+    uint8_t idx;
+
+    if (row == 0U) {
+        return (const CmdKeyNode_t *)0;
+    }
+    idx = cmd_dispatch.slot[row - 1U][key & 0xFFU];
+    if (idx == 0U) {
+        return (const CmdKeyNode_t *)0;
+    }
+    return &cmd_dispatch.node[idx - 1U];
 }
 
 /**
- * @brief Find mapping by 16-bit control key using binary search
- * @note command_map[] MUST be sorted by ctrl_key ascending
+ * @brief Find mapping by 16-bit control key (O(1), compile-time table)
  */
 const CommandMapping_t *FindMappingByCtrlKey(uint16_t key)
 {
-    int32_t low = 0;
-    int32_t high = (int32_t)CMD_MAP_COUNT - 1;
-    while (low <= high) {
-        int32_t mid = (low + high) >> 1;
-        uint16_t mid_key = command_map[mid].ctrl_key;
-        if (mid_key == key) {
-            return &command_map[mid];
-        } else if (mid_key < key) {
-            low = mid + 1;
-        } else {
-            high = mid - 1;
-        }
+    const CmdKeyNode_t *node = CmdFindNode(key);
+
+    if (node == (const CmdKeyNode_t *)0) {
+        return (const CommandMapping_t *)0;
     }
-    return (const CommandMapping_t *)0;
+    return &command_map[(node->count[CMD_TYPE_SET] != 0U) ? node->first[CMD_TYPE_SET] : node->first[CMD_TYPE_READ]];
 }
-uint8_t CalculateCtrlChecksum(const uint8_t *packet_ptr, uint8_t len)
+
+const CommandMapping_t *FindMappingForCtrlPacket(const CtrlPacketView_t *ctrl_view_ptr)
 {
-    uint32_t sum = 0U;
-    uint8_t i;
+    const CmdKeyNode_t *node;
+    uint8_t type;
 
-    if ((packet_ptr == NULL) || (len < 4U)) {
-        return 0U;
+    if ((ctrl_view_ptr == NULL) || !ctrl_view_ptr->checksum_ok) {
+        return (const CommandMapping_t *)0;
     }
 
-    /* Sum from LEN (index 1) up to byte before CS (len-3) */
-    for (i = 0U; i < (len - 3U); i++) {
-        sum += (uint32_t)packet_ptr[i];
+    node = CmdFindNode(ctrl_view_ptr->key);
+    if (node == (const CmdKeyNode_t *)0) {
+        return (const CommandMapping_t *)0;
     }
 
-    return (uint8_t)(sum%256);
+    /* reserve byte -> SET / READ kaydi */
+    if (ctrl_view_ptr->reserve == CTRL_PKT_RESERVE_SET) {
+        type = (uint8_t)CMD_TYPE_SET;
+    } else if (ctrl_view_ptr->reserve == CTRL_PKT_RESERVE_READ) {
+        type = (uint8_t)CMD_TYPE_READ;
+    } else {
+        return (const CommandMapping_t *)0;
+    }
+    if (node->count[type] == 0U) {
+        return (const CommandMapping_t *)0;
+    }
+
+    return &command_map[node->first[type]];
+}
+uint8_t CalculateCtrlChecksum(const uint8_t *packet_ptr, uint8_t len)
+{
+    if ((packet_ptr == NULL) || (len < 4U)) {
+        return 0U;
+    }
+
+    /* Sum from START (index 0) up to byte before CS (len-3), mod 256 */
+    return Checksum_Sum8(packet_ptr, (uint32_t)len - 3U);
 }
 
 uint8_t CalculateCamChecksum(const uint8_t *packet_ptr, uint8_t len)
 {
-    uint8_t xorv = 0U;
-    uint8_t i;
-
     if ((packet_ptr == NULL) || (len < 4U)) {
         return 0U;
     }
 
     /* XOR from LEN (index 2) up to byte before XOR (len-2) */
-    for (i = 2U; i < (len - 2U); i++) {
-        xorv ^= packet_ptr[i];
-    }
-
-    return xorv;
+    return Checksum_Xor8(&packet_ptr[2U], (uint32_t)len - 4U);
 }
 
 bool VerifyCtrlPacket(const uint8_t *packet_ptr, uint8_t len)
@@ -206,288 +397,593 @@ bool VerifyCamPacket(const uint8_t *packet_ptr, uint8_t len)
     return true;
 }
 
+void CtrlPacketView_Init(CtrlPacketView_t *view_ptr, const uint8_t *packet_ptr, uint16_t len, bool checksum_ok)
+{
+    if (view_ptr == NULL) {
+        return;
+    }
+
+    view_ptr->bytes = packet_ptr;
+    if ((packet_ptr == NULL) || (len < CTRL_PKT_MIN_SIZE) || (len > 0xFFU)) {
+        /* Protokol disi boy: alanlar okunmaz */
+        view_ptr->payload = packet_ptr;
+        view_ptr->key = 0U;
+        view_ptr->len = 0U;
+        view_ptr->reserve = 0U;
+        view_ptr->payload_len = 0U;
+        view_ptr->checksum_ok = false;
+        return;
+    }
+
+    view_ptr->payload = &packet_ptr[5U];
+    view_ptr->key = MAKE_CTRL_KEY(packet_ptr[2U], packet_ptr[3U]);
+    view_ptr->len = (uint8_t)len;
+    view_ptr->reserve = packet_ptr[4U];
+    view_ptr->payload_len = (uint8_t)(len - CTRL_PKT_MIN_SIZE);
+    view_ptr->checksum_ok = checksum_ok;
+}
+
+bool CtrlPacketView_Parse(CtrlPacketView_t *view_ptr, const uint8_t *packet_ptr, uint16_t len)
+{
+    const bool ok = (len <= 0xFFU) && VerifyCtrlPacket(packet_ptr, (uint8_t)len);
+
+    CtrlPacketView_Init(view_ptr, packet_ptr, len, ok);
+    return (view_ptr != NULL) && view_ptr->checksum_ok;
+}
+
+void CamPacketView_Init(CamPacketView_t *view_ptr, const uint8_t *packet_ptr, uint16_t len, bool checksum_ok)
+{
+    if (view_ptr == NULL) {
+        return;
+    }
+
+    view_ptr->bytes = packet_ptr;
+    if ((packet_ptr == NULL) || (len < (CAM_PKT_LEN_OVERHEAD + 1U)) || (len > 0xFFU)) {
+        view_ptr->body = packet_ptr;
+        view_ptr->len = 0U;
+        view_ptr->body_len = 0U;
+        view_ptr->checksum_ok = false;
+        return;
+    }
+
+    view_ptr->body = &packet_ptr[3U];
+    view_ptr->len = (uint8_t)len;
+    view_ptr->body_len = (uint8_t)(len - CAM_PKT_LEN_OVERHEAD);
+    view_ptr->checksum_ok = checksum_ok;
+}
+
+bool CamPacketView_Parse(CamPacketView_t *view_ptr, const uint8_t *packet_ptr, uint16_t len)
+{
+    const bool ok = (len <= 0xFFU) && VerifyCamPacket(packet_ptr, (uint8_t)len);
+
+    CamPacketView_Init(view_ptr, packet_ptr, len, ok);
+    return (view_ptr != NULL) && view_ptr->checksum_ok;
+}
+
 void CommandHandler_Init(void)
 {
-    /* Init pending buffer and lookup table */
+    /* Init pending buffer (dispatch table is built at compile time) */
     CmdRingBuffer_Init(&g_pending_commands);
-    CommandHandler_BuildLookup();
+    CommandHandler_ResetMemoStats();
+    CommandHandler_ResetMatchStats();
+    memset(g_memo, 0, sizeof(g_memo));
+    g_memo_clock = 0U;
+
+    /* Sahada guncellenebilir tablo: gecersizse sadece command_map kullanilir */
+    (void)CmdTab_LoadFromFlash();
 }
 
 
-TranslationResult_t CommandHandler_TranslateCtrlToCam(
-    const uint8_t *ctrl_packet_ptr,
-    uint8_t ctrl_len,
-    uint8_t *cam_packet_ptr,
-    uint8_t *cam_len_ptr)
+/* Hazir frame secimi: key_off'taki key_len byte keys[] icinde ikili aranir */
+static const uint8_t *CamFrameSelect(const CamFrameSet_t *set, const CtrlPacketView_t *ctrl_view_ptr)
 {
-	//    TranslationResult_t result = TRANSLATION_ERROR;
-	    if ((ctrl_packet_ptr == NULL) || (cam_packet_ptr == NULL) || (cam_len_ptr == NULL) || (ctrl_len < 8U)) {
-	        return TRANSLATION_INVALID_PACKET;
-	    }
-
-	    if (!VerifyCtrlPacket(ctrl_packet_ptr, ctrl_len)) {
-	        return TRANSLATION_CHECKSUM_ERROR;
-	    }
-	    /* Extract KB0, KB1 from control packet:
-	       AA [LEN] 00 KB0 KB1 ...
-	       KB0 == packet[3], KB1 == packet[4]
-	    */
-	    if (ctrl_len < 5U) {
-	           return TRANSLATION_INVALID_PACKET;
-	       }
-	    uint8_t kb0 = ctrl_packet_ptr[2U];
-		uint8_t kb1 = ctrl_packet_ptr[3U];
-		uint16_t key = MAKE_CTRL_KEY(kb0, kb1);
-		const CommandMapping_t *mapping = FindMappingByCtrlKey(key);
-		if (mapping == (const CommandMapping_t *)0) {
-			return TRANSLATION_UNKNOWN_CMD;
-		}
-	    /* If mapping has matcher, check it */
-//	    if ((mapping->matcher != NULL) && (mapping->matcher(ctrl_packet_ptr, ctrl_len) == false)) {
-//	        return TRANSLATION_UNKNOWN_CMD;
-//	    }
-	    if(ctrl_len==0x04)
-	    {
-
-	    }
-	    /* Build camera packet via translator */
-	    bool ok = mapping->translator(ctrl_packet_ptr, ctrl_len, cam_packet_ptr, cam_len_ptr);
-	    if (!ok) {
-	        return TRANSLATION_ERROR;
-	    }
-	    /* Push to pending buffer (store original ctrl request and mapping pointer) */
-	    if (!CmdRingBuffer_PushComplete(
-	            &g_pending_commands,
-	            ctrl_packet_ptr,
-	            (uint32_t)ctrl_len,
-	            mapping->query_id,
-	            (const void *)mapping)) {
-	        return TRANSLATION_QUEUE_FULL;
-	    }
-	    return TRANSLATION_OK;
+    uint8_t lo = 0U;
+    uint8_t hi = set->count;
 
+    if (set->key_len == 0U) {
+        return set->frames;
+    }
+    if (((uint32_t)set->key_off + set->key_len + TR_CTRL_TAIL_SIZE) > ctrl_view_ptr->len) {
+        return (const uint8_t *)0;
+    }
+    while (lo < hi) {
+        const uint8_t mid = (uint8_t)((lo + hi) >> 1U);
+        const int cmp = memcmp(&set->keys[(uint32_t)mid * set->key_len], &ctrl_view_ptr->bytes[set->key_off], set->key_len);
+        if (cmp == 0) {
+            return &set->frames[(uint32_t)mid * set->frame_len];
+        } else if (cmp < 0) {
+            lo = (uint8_t)(mid + 1U);
+        } else {
+            hi = mid;
+        }
+    }
+    return (const uint8_t *)0;      /* kumede olmayan deger */
 }
-/**
- * @brief Process incoming camera response and generate control response
- */
-TranslationResult_t CommandHandler_ProcessCamResponse(
-    const uint8_t *cam_response_ptr,
-    uint8_t cam_len,
-    uint8_t *ctrl_response_ptr,
-    uint8_t *ctrl_len_ptr)
+
+/* FNV-1a: frame basina bir kez, byte basina xor + carpma */
+static uint32_t CmdMemoHash(const uint8_t *ctrl_packet_ptr, uint8_t ctrl_len)
 {
-    TranslationResult_t result = TRANSLATION_ERROR;
-    cmdBlock_t pending;
-    const CommandMapping_t *mapping = NULL;
-    bool pop_ok;
-    bool gen_ok;
+    uint32_t h = 2166136261UL;
 
-    if ((cam_response_ptr == NULL) || (ctrl_response_ptr == NULL) || (ctrl_len_ptr == NULL)) {
-        return TRANSLATION_INVALID_PACKET;
+    for (uint8_t i = 0U; i < ctrl_len; i++) {
+        h = (h ^ ctrl_packet_ptr[i]) * 16777619UL;
     }
+    return (h != 0U) ? h : 1U;     /* 0 bos kayit icin ayrildi */
+}
 
-    if (!VerifyCamPacket(cam_response_ptr, cam_len)) {
-        return TRANSLATION_CHECKSUM_ERROR;
+static const CmdMemoEntry_t *CmdMemoFind(uint32_t hash, const uint8_t *ctrl_packet_ptr, uint8_t ctrl_len)
+{
+    for (uint8_t i = 0U; i < CMD_MEMO_ENTRIES; i++) {
+        CmdMemoEntry_t *e = &g_memo[i];
+        if ((e->hash == hash) && (e->ctrl_len == ctrl_len) &&
+            (memcmp(e->ctrl, ctrl_packet_ptr, ctrl_len) == 0)) {
+            e->stamp = ++g_memo_clock;
+            return e;
+        }
     }
+    return (const CmdMemoEntry_t *)0;
+}
 
-    /* Pop oldest pending command */
-    pop_ok = CmdRingBuffer_Pop(&g_pending_commands, &pending);
-    if (!pop_ok) {
-        return TRANSLATION_INVALID_PACKET;
+/* frame_static: frame flash'ta (pointer saklanir), degilse cam[]'e kopyalanir */
+static void CmdMemoStore(uint32_t hash, const uint8_t *ctrl_packet_ptr, uint8_t ctrl_len,
+                         const uint8_t *frame, bool frame_static, uint8_t cam_len,
+                         const CommandMapping_t *mapping, queryBitEnum query_id,
+                         uint8_t prio, uint8_t coalesce)
+{
+    CmdMemoEntry_t *victim = &g_memo[0];
+
+    if ((ctrl_len > CMD_MEMO_CTRL_MAX) || (cam_len > TR_CAM_PKT_MAX)) {
+        return;
+    }
+    /* Bos kayit, yoksa en eski */
+    for (uint8_t i = 0U; i < CMD_MEMO_ENTRIES; i++) {
+        if (g_memo[i].hash == 0U) {
+            victim = &g_memo[i];
+            break;
+        }
+        if (g_memo[i].stamp < victim->stamp) {
+            victim = &g_memo[i];
+        }
+    }
+    if (victim->hash != 0U) {
+        g_memo_stats.evictions++;
     }
 
-    mapping = (const CommandMapping_t *)pending.mapping;
-    if (mapping == (const CommandMapping_t *)0) {
-        return TRANSLATION_ERROR;
+    victim->hash = hash;
+    victim->stamp = ++g_memo_clock;
+    victim->mapping = mapping;
+    victim->query_id = query_id;
+    victim->prio = prio;
+    victim->coalesce = coalesce;
+    victim->ctrl_len = ctrl_len;
+    victim->cam_len = cam_len;
+    (void)memcpy(victim->ctrl, ctrl_packet_ptr, ctrl_len);
+    if (frame_static) {
+        victim->frame = frame;
+    } else {
+        victim->frame = NULL;
+        (void)memcpy(victim->cam, frame, cam_len);
     }
+}
 
-    /* Call response generator */
-    gen_ok = mapping->response_gen(
-        cam_response_ptr,
-        cam_len,
-        pending.original_request,
-        (uint8_t)pending.request_lenth,
-        ctrl_response_ptr,
-        ctrl_len_ptr);
+TranslationResult_t CommandHandler_PrepareCtrlView(
+    const CtrlPacketView_t *ctrl_view_ptr,
+    uint8_t *scratch_ptr,
+    const uint8_t **cam_frame_ptr,
+    uint8_t *cam_len_ptr,
+    cmdBlock_t *req_ptr)
+{
+    const CommandMapping_t *mapping;
+    const CmdMemoEntry_t *memo;
+    queryBitEnum query_id;
+    uint8_t prio;
+    uint8_t coalesce;
+    uint32_t hash;
+    bool ok;
+
+    if ((ctrl_view_ptr == NULL) || (scratch_ptr == NULL) || (cam_frame_ptr == NULL) ||
+        (cam_len_ptr == NULL) || (req_ptr == NULL)) {
+        return TRANSLATION_INVALID_PACKET;
+    }
 
-    if (!gen_ok) {
-        return TRANSLATION_ERROR;
+    /* Framer (ya da CtrlPacketView_Parse) dogruladi: burada tekrar hesaplanmaz */
+    if (!ctrl_view_ptr->checksum_ok) {
+        return TRANSLATION_CHECKSUM_ERROR;
+    }
+
+    /* Ayni frame daha once cevrildiyse: arama, eslesme ve ceviri atlanir */
+    hash = CmdMemoHash(ctrl_view_ptr->bytes, ctrl_view_ptr->len);
+    memo = CmdMemoFind(hash, ctrl_view_ptr->bytes, ctrl_view_ptr->len);
+    if (memo != (const CmdMemoEntry_t *)0) {
+        g_memo_stats.hits++;
+        mapping = memo->mapping;
+        query_id = memo->query_id;
+        prio = memo->prio;
+        coalesce = memo->coalesce;
+        *cam_len_ptr = memo->cam_len;
+        if (memo->frame != NULL) {
+            *cam_frame_ptr = memo->frame;
+        } else {
+            /* Cache kaydi tahliye edilebilir: DMA'ya scratch verilir */
+            (void)memcpy(scratch_ptr, memo->cam, memo->cam_len);
+            *cam_frame_ptr = scratch_ptr;
+        }
+    } else {
+        g_memo_stats.misses++;
+
+        /* Once flash tablosu, sonra derleme aninda karar tablosu */
+        const CmdTabCommand_t *bc = CmdTab_FindForCtrlPacket(ctrl_view_ptr);
+        *cam_frame_ptr = scratch_ptr;
+        if (bc != (const CmdTabCommand_t *)0) {
+            mapping = &cmdtab_resp_map[bc->resp];
+            query_id = (queryBitEnum)bc->query_id;
+            prio = bc->prio;
+            coalesce = bc->coalesce;
+            ok = CmdTab_Translate(bc, ctrl_view_ptr, scratch_ptr, cam_len_ptr);
+        } else {
+            mapping = FindMappingForCtrlPacket(ctrl_view_ptr);
+            if (mapping == (const CommandMapping_t *)0) {
+                return TRANSLATION_UNKNOWN_CMD;
+            }
+            query_id = mapping->query_id;
+            prio = (uint8_t)mapping->prio;
+            /* Parametre ayari olan set komutlari sirada birlestirilebilir; tek
+               frame'li set (Manuel NUC gibi) bir eylemdir, her biri kameraya gider */
+            coalesce = ((mapping->type == CMD_TYPE_SET) &&
+                        !((mapping->frames != NULL) && (mapping->frames->key_len == 0U))) ? 1U : 0U;
+            if (mapping->frames != NULL) {
+                /* Sonlu kume: hazir frame, byte uretimi / XOR yok */
+                *cam_frame_ptr = CamFrameSelect(mapping->frames, ctrl_view_ptr);
+                *cam_len_ptr = mapping->frames->frame_len;
+                ok = (*cam_frame_ptr != NULL);
+                if (!ok && (mapping->translator != NULL)) {
+                    /* Kumede olmayan deger: translator ile oldugu gibi ilet */
+                    *cam_frame_ptr = scratch_ptr;
+                    ok = mapping->translator(ctrl_view_ptr, scratch_ptr, cam_len_ptr);
+                }
+            } else {
+                /* Build camera packet via translator */
+                ok = mapping->translator(ctrl_view_ptr, scratch_ptr, cam_len_ptr);
+            }
+        }
+        if (!ok) {
+            return TRANSLATION_ERROR;
+        }
+        CmdMemoStore(hash, ctrl_view_ptr->bytes, ctrl_view_ptr->len, *cam_frame_ptr,
+                     (*cam_frame_ptr != scratch_ptr), *cam_len_ptr, mapping, query_id, prio, coalesce);
     }
 
+    /* Pending record (request fields from the view, mapping pointer,
+       camera command and expected response shape for correlation) */
+    if (!CmdRingBuffer_MakeBlock(
+            req_ptr,
+            ctrl_view_ptr,
+            query_id,
+            (const void *)mapping,
+            &(*cam_frame_ptr)[3U],
+            (ctrl_view_ptr->reserve == CTRL_PKT_RESERVE_READ) ? CMD_RESP_SHAPE_DATA : CMD_RESP_SHAPE_ACK)) {
+        return TRANSLATION_INVALID_PACKET;
+    }
+    /* Gonderim sinifi ve birlestirme: karar tablosu ya da flash tablosu kaydindan */
+    req_ptr->prio = prio;
+    req_ptr->coalesce = coalesce;
     return TRANSLATION_OK;
 }
 
-uint8_t CommandHandler_CheckTimeouts(void)
+bool CommandHandler_CommitSent(const cmdBlock_t *req_ptr)
 {
-    uint8_t removed = 0U;
-    uint32_t now = HAL_GetTick();
-    bool again;
+    return CmdRingBuffer_PushBlock(&g_pending_commands, req_ptr);
+}
 
-    do {
-        again = CmdRingBuffer_RemoveIfTimeOut(&g_pending_commands, COMMAND_TIMEOUT_MS, now);
-        if (again) {
-            removed++;
-        }
-    } while (again);
+bool CommandHandler_AttachReadWaiter(const cmdBlock_t *req_ptr)
+{
+    if ((req_ptr == NULL) || (req_ptr->shape != (uint8_t)CMD_RESP_SHAPE_DATA)) {
+        return false;
+    }
+    return CmdRingBuffer_AttachWaiter(&g_pending_commands, req_ptr->nmbr);
+}
 
-    return removed;
+void CommandHandler_CloseReads(const cmdBlock_t *set_req_ptr)
+{
+    CmdRingBuffer_CloseReads(&g_pending_commands, set_req_ptr);
 }
 
-uint32_t CommandHandler_GetPendingCount(void)
+TranslationResult_t CommandHandler_TranslateCtrlView(
+    const CtrlPacketView_t *ctrl_view_ptr,
+    uint8_t *scratch_ptr,
+    const uint8_t **cam_frame_ptr,
+    uint8_t *cam_len_ptr)
 {
-    return CmdRingBuffer_Size(&g_pending_commands);
+    cmdBlock_t req;
+    TranslationResult_t tr;
+
+    tr = CommandHandler_PrepareCtrlView(ctrl_view_ptr, scratch_ptr, cam_frame_ptr, cam_len_ptr, &req);
+    if (tr != TRANSLATION_OK) {
+        return tr;
+    }
+
+    /* Push to pending buffer */
+    if (!CommandHandler_CommitSent(&req)) {
+        return TRANSLATION_QUEUE_FULL;
+    }
+    return TRANSLATION_OK;
 }
 
+TranslationResult_t CommandHandler_TranslateCtrlToCam(
+    const uint8_t *ctrl_packet_ptr,
+    uint8_t ctrl_len,
+    uint8_t *cam_packet_ptr,
+    uint8_t *cam_len_ptr)
+{
+    CtrlPacketView_t view;
+    const uint8_t *frame = NULL;
+    TranslationResult_t tr;
+
+    if ((ctrl_packet_ptr == NULL) || (ctrl_len < CTRL_PKT_MIN_SIZE)) {
+        return TRANSLATION_INVALID_PACKET;
+    }
+    (void)CtrlPacketView_Parse(&view, ctrl_packet_ptr, ctrl_len);
 
-/* Simple set translator: single payload byte -> camera simple cmd */
-static bool Translator_SimpleSet(
-    const uint8_t *ctrl_packet_ptr, uint8_t ctrl_len,
-    uint8_t *cam_packet_ptr, uint8_t *cam_len_ptr)
+    tr = CommandHandler_TranslateCtrlView(&view, cam_packet_ptr, &frame, cam_len_ptr);
+    if ((tr == TRANSLATION_OK) && (frame != cam_packet_ptr)) {
+        (void)memcpy(cam_packet_ptr, frame, *cam_len_ptr);
+    }
+    return tr;
+}
+/* Bekleyen komut icin kontrol yanitini uret (sabit ACK flash'tan) */
+static bool GenerateCtrlResponse(
+    const CamPacketView_t *cam_view_ptr,
+    const cmdBlock_t *pending,
+    uint8_t *scratch_ptr,
+    const uint8_t **ctrl_frame_ptr,
+    uint8_t *ctrl_len_ptr)
 {
-    uint8_t payload[2]={0x00,0x01};
-    uint8_t idx = 0U;
-    uint8_t xorv = 0U;
-    uint8_t i;
+    const CommandMapping_t *mapping = (const CommandMapping_t *)pending->mapping;
 
-    if ((ctrl_packet_ptr == NULL) || (cam_packet_ptr == NULL) || (cam_len_ptr == NULL) || (ctrl_len < 8U)) {
+    if (mapping == (const CommandMapping_t *)0) {
         return false;
     }
 
-    /* payload typically at index 5 for set commands */
+    if (mapping->response_gen == ResponseGen_SimpleACK) {
+        /* Sabit yanit: uretim/checksum yok, flash'tan gonderilir */
+        *ctrl_frame_ptr = ctrl_ack.cmd[pending->ctrl_cmd].b;
+        *ctrl_len_ptr = TrCtrlFrame<1U>::size;
+        return true;
+    }
+
+    /* Call response generator */
+    *ctrl_frame_ptr = scratch_ptr;
+    return mapping->response_gen(
+        cam_view_ptr,
+        pending,
+        scratch_ptr,
+        ctrl_len_ptr);
+}
+
+/**
+ * @brief Process incoming camera response and generate control response
+ *        (sabit ACK yanitinda flash'taki hazir frame doner)
+ */
+TranslationResult_t CommandHandler_ProcessCamResponseView(
+    const CamPacketView_t *cam_view_ptr,
+    uint8_t *scratch_ptr,
+    const uint8_t **ctrl_frame_ptr,
+    uint8_t *ctrl_len_ptr,
+    uint16_t *copies_ptr)
+{
+    const cmdBlock_t *pending;
+    cmdMatchKind_t match;
+    bool gen_ok;
 
+    if ((cam_view_ptr == NULL) || (scratch_ptr == NULL) || (ctrl_frame_ptr == NULL) || (ctrl_len_ptr == NULL)) {
+        return TRANSLATION_INVALID_PACKET;
+    }
 
-    /* build camera packet: 55 AA LEN B1 B2 B3 PAYLOAD XOR F0
-       sample values used here; adjust cam_cmd bytes as needed */
+    if (!cam_view_ptr->checksum_ok) {
+        return TRANSLATION_CHECKSUM_ERROR;
+    }
 
-    //TODO:  Bu noktada payload seçimi yapılacak.
-    cam_packet_ptr[idx++] = CAM_PKT_START1;    /* 55 */
-    cam_packet_ptr[idx++] = CAM_PKT_START2;    /* AA */
-    cam_packet_ptr[idx++] = 0x07U;             /* LEN placeholder (55 AA excluded) */
-    cam_packet_ptr[idx++] = 0x02U;             /* CMD1 (example) */
-    cam_packet_ptr[idx++] = 0x01U;             /* CMD2 (example) */
-    cam_packet_ptr[idx++] = 0x08U;             /* CMD3 (example) */
-    cam_packet_ptr[idx++] = 0x00U;             /* Zero */
-    cam_packet_ptr[idx++] = 0x00U;             /* Zero */
-    cam_packet_ptr[idx++] = payload[0];           /* payload */
-    cam_packet_ptr[idx++] = payload[1];           /* payload */
+    /* Yanitin ait oldugu bekleyen komut (echo / sekil, belirsizse en eski),
+       yerinde okunur (kopya yok) */
+    pending = CmdRingBuffer_Match(&g_pending_commands, cam_view_ptr, &match);
+    g_match_stats.count[match]++;
+    if (pending == NULL) {
+        return TRANSLATION_INVALID_PACKET;
+    }
+
+    gen_ok = GenerateCtrlResponse(cam_view_ptr, pending, scratch_ptr, ctrl_frame_ptr, ctrl_len_ptr);
 
-    /* XOR from index 2 to before XOR */
-    xorv = 0U;
-    for (i = 2U; i < idx; i++) {
-        xorv ^= cam_packet_ptr[i];
+    /* Tek ucus: ayni sorguya eklenen her okuma ayni yaniti alir */
+    if (copies_ptr != NULL) {
+        *copies_ptr = (uint16_t)(1U + pending->waiters);
     }
 
-    cam_packet_ptr[idx++] = xorv;
-    cam_packet_ptr[idx++] = CAM_PKT_END;
+    /* Answered (or failed): remove from pending list */
+    (void)CmdRingBuffer_Remove(&g_pending_commands, pending);
 
-    *cam_len_ptr = idx;
-    return true;
+    if (!gen_ok) {
+        return TRANSLATION_ERROR;
+    }
+
+    return TRANSLATION_OK;
 }
 
-/* Zoom translator: copy 10-byte zoom payload into camera packet */
-static bool Translator_ZoomSet(
-    const uint8_t *ctrl_packet_ptr, uint8_t ctrl_len,
-    uint8_t *cam_packet_ptr, uint8_t *cam_len_ptr)
+TranslationResult_t CommandHandler_RespondSuperseded(
+    const cmdBlock_t *req_ptr,
+    uint8_t *scratch_ptr,
+    const uint8_t **ctrl_frame_ptr,
+    uint8_t *ctrl_len_ptr)
 {
-    uint8_t idx = 0U;
-    uint8_t xorv = 0U;
-    uint8_t i;
-    const uint8_t payload_len = 10U;
+    /* Kameranin ortak ACK'i (55 AA 01 00 01 F0) gelmis gibi */
+    static const uint8_t cam_ack[] = { CAM_PKT_START1, CAM_PKT_START2, 0x01U, 0x00U, 0x01U, CAM_PKT_END };
+    CamPacketView_t view;
 
-    if ((ctrl_packet_ptr == NULL) || (cam_packet_ptr == NULL) || (cam_len_ptr == NULL)) {
-        return false;
+    if ((req_ptr == NULL) || (scratch_ptr == NULL) || (ctrl_frame_ptr == NULL) || (ctrl_len_ptr == NULL)) {
+        return TRANSLATION_INVALID_PACKET;
     }
 
-    /* minimal ctrl length for zoom set expected around 18 (AA + 0x0D + ... ) */
-    if (ctrl_len < (5U + payload_len + 3U)) { /* rough check */
-        return false;
+    CamPacketView_Init(&view, cam_ack, (uint16_t)sizeof(cam_ack), true);
+    if (!GenerateCtrlResponse(&view, req_ptr, scratch_ptr, ctrl_frame_ptr, ctrl_len_ptr)) {
+        return TRANSLATION_ERROR;
     }
+    return TRANSLATION_OK;
+}
 
-    /* build header */
-    cam_packet_ptr[idx++] = CAM_PKT_START1;
-    cam_packet_ptr[idx++] = CAM_PKT_START2;
-    cam_packet_ptr[idx++] = 0x00U;  /* LEN filled later */
-    cam_packet_ptr[idx++] = 0x02U;  /* CMD1 */
-    cam_packet_ptr[idx++] = 0x01U;  /* CMD2 */
-    cam_packet_ptr[idx++] = 0x08U;  /* CMD3 (zoom) */
+TranslationResult_t CommandHandler_ProcessCamResponse(
+    const uint8_t *cam_response_ptr,
+    uint8_t cam_len,
+    uint8_t *ctrl_response_ptr,
+    uint8_t *ctrl_len_ptr)
+{
+    CamPacketView_t view;
+    const uint8_t *frame = NULL;
+    TranslationResult_t tr;
 
-    /* copy 10 bytes from ctrl payload starting at ctrl_packet_ptr[5] */
-    for (i = 0U; i < payload_len; i++) {
-        cam_packet_ptr[idx++] = ctrl_packet_ptr[5U + i];
+    if (cam_response_ptr == NULL) {
+        return TRANSLATION_INVALID_PACKET;
     }
+    (void)CamPacketView_Parse(&view, cam_response_ptr, cam_len);
 
-    /* update LEN: count of bytes after 55 AA up to and including checksum */
-    cam_packet_ptr[2U] = (uint8_t)(idx - 2U);
-
-    /* XOR */
-    xorv = 0U;
-    for (i = 2U; i < idx; i++) {
-        xorv ^= cam_packet_ptr[i];
+    tr = CommandHandler_ProcessCamResponseView(&view, ctrl_response_ptr, &frame, ctrl_len_ptr, NULL);
+    if ((tr == TRANSLATION_OK) && (frame != ctrl_response_ptr)) {
+        (void)memcpy(ctrl_response_ptr, frame, *ctrl_len_ptr);
     }
-    cam_packet_ptr[idx++] = xorv;
-    cam_packet_ptr[idx++] = CAM_PKT_END;
+    return tr;
+}
 
-    *cam_len_ptr = idx;
-    return true;
+#if (CMD_TRANSLATE_CYCLE_STATS == 1)
+/* Sentetik paketle translator'u iterations kez calistir, ortalama cevrim */
+static uint32_t ProfileOne(const CommandMapping_t *native, const CmdTabCommand_t *bc,
+                           uint32_t order, uint16_t iterations)
+{
+    static uint8_t pkt[255];
+    uint8_t cam[TR_CAM_PKT_MAX];
+    uint8_t cam_len;
+    CtrlPacketView_t view;
+    uint32_t start;
+    uint32_t total = 0U;
+    bool ok = true;
+
+    memset(pkt, 0, sizeof(pkt));
+    pkt[0] = CTRL_PKT_START_AA;
+    pkt[2] = (uint8_t)(order >> 24U);
+    pkt[3] = (uint8_t)(order >> 16U);
+    pkt[4] = (((order >> 9U) & 1U) == (uint32_t)CMD_TYPE_SET) ? CTRL_PKT_RESERVE_SET : CTRL_PKT_RESERVE_READ;
+    pkt[5] = (uint8_t)order;    /* P0 (ANY icin 0) */
+    if ((native != NULL) && (native->frames != NULL) && (native->frames->key_len != 0U)) {
+        /* Hazir frame: kumenin ilk anahtari */
+        (void)memcpy(&pkt[native->frames->key_off], native->frames->keys, native->frames->key_len);
+    }
+    /* Sentetik paketin checksum'i yok: gorunum dogrulanmis kabul edilir */
+    CtrlPacketView_Init(&view, pkt, (uint16_t)sizeof(pkt), true);
+
+    for (uint16_t i = 0U; (i < iterations) && ok; i++) {
+        start = DWT->CYCCNT;
+        if (bc != (const CmdTabCommand_t *)0) {
+            ok = CmdTab_Translate(bc, &view, cam, &cam_len);
+        } else if (native->frames != NULL) {
+            ok = (CamFrameSelect(native->frames, &view) != NULL);
+        } else {
+            ok = native->translator(&view, cam, &cam_len);
+        }
+        total += DWT->CYCCNT - start;
+    }
+    return (ok && (iterations != 0U)) ? (total / iterations) : 0U;
 }
 
-/* Read/query translator: map control read into camera query */
-static bool Translator_ReadQuery(
-    const uint8_t *ctrl_packet_ptr, uint8_t ctrl_len,
-    uint8_t *cam_packet_ptr, uint8_t *cam_len_ptr)
+uint8_t CommandHandler_ProfileTranslators(CmdTranslateCost_t *out, uint8_t max_rows, uint16_t iterations)
 {
-    uint8_t ctrl_cmd;
-    uint8_t cam_query;
-    uint8_t idx = 0U;
-    uint8_t xorv = 0U;
-    uint8_t i;
+    uint8_t rows = 0U;
 
-    if ((ctrl_packet_ptr == NULL) || (cam_packet_ptr == NULL) || (cam_len_ptr == NULL)) {
-        return false;
+    if (out == NULL) {
+        return 0U;
     }
 
-    if (ctrl_len < 8U) {
-        return false;
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+
+    /* command_map satirlari; tabloda esi varsa ayni satirda */
+    for (uint32_t i = 0U; (i < CMD_MAP_COUNT) && (rows < max_rows); i++) {
+        const uint32_t order = CmdOrderKey(command_map[i]);
+        out[rows].order = order;
+        out[rows].native_cycles = ProfileOne(&command_map[i], (const CmdTabCommand_t *)0, order, iterations);
+        out[rows].bytecode_cycles = 0U;
+        for (uint8_t k = 0U; k < CmdTab_GetCount(); k++) {
+            if (CmdTab_GetCommand(k)->order == order) {
+                out[rows].bytecode_cycles = ProfileOne(NULL, CmdTab_GetCommand(k), order, iterations);
+            }
+        }
+        rows++;
     }
 
-    ctrl_cmd = ctrl_packet_ptr[3U];
+    /* Sadece tabloda olan komutlar */
+    for (uint8_t k = 0U; (k < CmdTab_GetCount()) && (rows < max_rows); k++) {
+        const CmdTabCommand_t *bc = CmdTab_GetCommand(k);
+        bool native = false;
+        for (uint32_t i = 0U; i < CMD_MAP_COUNT; i++) {
+            if (CmdOrderKey(command_map[i]) == bc->order) {
+                native = true;
+            }
+        }
+        if (!native) {
+            out[rows].order = bc->order;
+            out[rows].native_cycles = 0U;
+            out[rows].bytecode_cycles = ProfileOne(NULL, bc, bc->order, iterations);
+            rows++;
+        }
+    }
+    return rows;
+}
+#endif
 
-    /* map ctrl_cmd to camera query type */
-    if (ctrl_cmd == 0x03U) {
-        cam_query = 0x10U; /* status */
-    } else if (ctrl_cmd == 0x04U) {
-        cam_query = 0x20U; /* temperature */
-    } else if (ctrl_cmd == 0x05U) {
-        cam_query = 0x30U; /* version */
-    } else {
-        return false;
+uint8_t CommandHandler_CheckTimeouts(void)
+{
+    uint8_t removed = 0U;
+    uint32_t now = HAL_GetTick();
+    bool again;
+
+    do {
+        again = CmdRingBuffer_RemoveIfTimeOut(&g_pending_commands, COMMAND_TIMEOUT_MS, now);
+        if (again) {
+            removed++;
+        }
+    } while (again);
+
+    return removed;
+}
+
+void CommandHandler_GetMemoStats(CmdMemoStats_t *out)
+{
+    if (out != NULL) {
+        *out = g_memo_stats;
     }
+}
 
-    /* build camera query packet (example layout) */
-    cam_packet_ptr[idx++] = CAM_PKT_START1;
-    cam_packet_ptr[idx++] = CAM_PKT_START2;
-    cam_packet_ptr[idx++] = 0x07U;   /* LEN */
-    cam_packet_ptr[idx++] = 0x02U;   /* CMD1 */
-    cam_packet_ptr[idx++] = 0x02U;   /* CMD2 = query */
-    cam_packet_ptr[idx++] = cam_query;/* CMD3 = which query */
-    /* add dummy payload 4 bytes as in examples */
-    cam_packet_ptr[idx++] = 0x00U;
-    cam_packet_ptr[idx++] = 0x00U;
-    cam_packet_ptr[idx++] = 0x00U;
-    cam_packet_ptr[idx++] = 0x00U;
-
-    /* XOR */
-    xorv = 0U;
-    for (i = 2U; i < idx; i++) {
-        xorv ^= cam_packet_ptr[i];
-    }
-    cam_packet_ptr[idx++] = xorv;
-    cam_packet_ptr[idx++] = CAM_PKT_END;
-
-    *cam_len_ptr = idx;
-    return true;
+void CommandHandler_ResetMemoStats(void)
+{
+    g_memo_stats.hits = 0U;
+    g_memo_stats.misses = 0U;
+    g_memo_stats.evictions = 0U;
+}
+
+void CommandHandler_GetMatchStats(CmdMatchStats_t *out)
+{
+    if (out != NULL) {
+        *out = g_match_stats;
+    }
+}
+
+void CommandHandler_ResetMatchStats(void)
+{
+    (void)memset(&g_match_stats, 0, sizeof(g_match_stats));
+}
+
+uint32_t CommandHandler_GetPendingCount(void)
+{
+    return CmdRingBuffer_Size(&g_pending_commands);
 }
 
+
 /* Helper: build simple control response: 55 LEN 00 CMD 33 01 [opt payload] CS EB AA */
 static void BuildCtrlResponseHeader(
     uint8_t *buf, uint8_t *pos, uint8_t cmd, uint8_t payload_len)
@@ -501,62 +997,44 @@ static void BuildCtrlResponseHeader(
     /* For set response add fixed 0x01 (ACK) as per spec, for read responses payload will follow */
 }
 
-/* Simple ACK response for set commands */
+/* Simple ACK response for set commands (hazir frame'in kopyasi) */
 static bool ResponseGen_SimpleACK(
-    const uint8_t *cam_resp_ptr, uint8_t cam_len,
-    const uint8_t *orig_ctrl_ptr, uint8_t orig_ctrl_len,
+    const CamPacketView_t *cam_view_ptr,
+    const cmdBlock_t *pending_ptr,
     uint8_t *ctrl_resp_ptr, uint8_t *ctrl_resp_len_ptr)
 {
-    uint8_t pos = 0U;
-    uint8_t cmd;
-
-
-    if ((orig_ctrl_ptr == NULL) || (ctrl_resp_ptr == NULL) || (ctrl_resp_len_ptr == NULL) || (orig_ctrl_len < 4U)) {
+    if ((pending_ptr == NULL) || (ctrl_resp_ptr == NULL) || (ctrl_resp_len_ptr == NULL) || (pending_ptr->request_lenth < 4U)) {
         return false;
     }
 
-    cmd = orig_ctrl_ptr[3U];
-
-    /* header */
-    BuildCtrlResponseHeader(ctrl_resp_ptr, &pos, cmd, 0U);
-    ctrl_resp_ptr[pos++] = CTRL_PKT_RESP_ACK_BYTE; /* 0x01 */
-    ctrl_resp_ptr[pos++] = CalculateCtrlChecksum(ctrl_resp_ptr,CONSTANT_PL_FOR_CALC_CS);
-    /* end bytes */
-    ctrl_resp_ptr[pos++] = CTRL_PKT_END_EB;
-    ctrl_resp_ptr[pos++] = CTRL_PKT_END_AA;
-
-    *ctrl_resp_len_ptr = pos;
+    (void)memcpy(ctrl_resp_ptr, ctrl_ack.cmd[pending_ptr->ctrl_cmd].b, TrCtrlFrame<1U>::size);
+    *ctrl_resp_len_ptr = TrCtrlFrame<1U>::size;
     return true;
 }
 
 /* Echo parameter: return the parameter from original request (payload[0]) */
 static bool ResponseGen_EchoParam(
-    const uint8_t *cam_resp_ptr, uint8_t cam_len,
-    const uint8_t *orig_ctrl_ptr, uint8_t orig_ctrl_len,
+    const CamPacketView_t *cam_view_ptr,
+    const cmdBlock_t *pending_ptr,
     uint8_t *ctrl_resp_ptr, uint8_t *ctrl_resp_len_ptr)
 {
     uint8_t pos = 0U;
     uint8_t cmd;
     uint8_t cs;
-    uint8_t i;
-    uint32_t sum = 0U;
     uint8_t param = 0U;
 
-    if ((orig_ctrl_ptr == NULL) || (ctrl_resp_ptr == NULL) || (ctrl_resp_len_ptr == NULL) || (orig_ctrl_len < 6U)) {
+    if ((pending_ptr == NULL) || (ctrl_resp_ptr == NULL) || (ctrl_resp_len_ptr == NULL) || (pending_ptr->request_lenth < 6U)) {
         return false;
     }
 
-    cmd = orig_ctrl_ptr[3U];
-    param = orig_ctrl_ptr[5U]; /* echo first payload byte */
+    cmd = pending_ptr->ctrl_cmd;
+    param = pending_ptr->ctrl_param; /* echo first payload byte */
 
     BuildCtrlResponseHeader(ctrl_resp_ptr, &pos, cmd, 1U);
     ctrl_resp_ptr[pos++] = param;
 
     /* checksum */
-    for (i = 1U; i < pos; i++) {
-        sum += (uint32_t)ctrl_resp_ptr[i];
-    }
-    cs = (uint8_t)(sum & 0xFFU);
+    cs = Checksum_Sum8(&ctrl_resp_ptr[1], (uint32_t)pos - 1U);
     ctrl_resp_ptr[pos++] = cs;
 
     ctrl_resp_ptr[pos++] = CTRL_PKT_END_EB;
@@ -568,30 +1046,28 @@ static bool ResponseGen_EchoParam(
 
 /* Multi param response: extract multiple bytes from camera response and convert */
 static bool ResponseGen_MultiParam(
-    const uint8_t *cam_resp_ptr, uint8_t cam_len,
-    const uint8_t *orig_ctrl_ptr, uint8_t orig_ctrl_len,
+    const CamPacketView_t *cam_view_ptr,
+    const cmdBlock_t *pending_ptr,
     uint8_t *ctrl_resp_ptr, uint8_t *ctrl_resp_len_ptr)
 {
     uint8_t pos = 0U;
     uint8_t cmd;
     uint8_t cs;
-    uint8_t i;
-    uint32_t sum = 0U;
     uint8_t b0 = 0U, b1 = 0U, b2 = 0U, b3 = 0U;
 
-    if ((cam_resp_ptr == NULL) || (orig_ctrl_ptr == NULL) || (ctrl_resp_ptr == NULL) || (ctrl_resp_len_ptr == NULL)) {
+    if ((cam_view_ptr == NULL) || (pending_ptr == NULL) || (ctrl_resp_ptr == NULL) || (ctrl_resp_len_ptr == NULL)) {
         return false;
     }
 
     /* Example: assume camera payload bytes at index 4..7 (depends on cam format) */
-    if (cam_len >= 7U) {
-        b0 = cam_resp_ptr[4U];
-        b1 = (cam_len > 5U) ? cam_resp_ptr[5U] : 0U;
-        b2 = (cam_len > 6U) ? cam_resp_ptr[6U] : 0U;
-        b3 = (cam_len > 7U) ? cam_resp_ptr[7U] : 0U;
+    if (cam_view_ptr->len >= 7U) {
+        b0 = cam_view_ptr->bytes[4U];
+        b1 = (cam_view_ptr->len > 5U) ? cam_view_ptr->bytes[5U] : 0U;
+        b2 = (cam_view_ptr->len > 6U) ? cam_view_ptr->bytes[6U] : 0U;
+        b3 = (cam_view_ptr->len > 7U) ? cam_view_ptr->bytes[7U] : 0U;
     }
 
-    cmd = orig_ctrl_ptr[3U];
+    cmd = pending_ptr->ctrl_cmd;
 
     /* build response with 4-byte payload */
     BuildCtrlResponseHeader(ctrl_resp_ptr, &pos, cmd, 4U);
@@ -601,10 +1077,7 @@ static bool ResponseGen_MultiParam(
     ctrl_resp_ptr[pos++] = b3;
 
     /* checksum */
-    for (i = 1U; i < pos; i++) {
-        sum += (uint32_t)ctrl_resp_ptr[i];
-    }
-    cs = (uint8_t)(sum & 0xFFU);
+    cs = Checksum_Sum8(&ctrl_resp_ptr[1], (uint32_t)pos - 1U);
     ctrl_resp_ptr[pos++] = cs;
 
     ctrl_resp_ptr[pos++] = CTRL_PKT_END_EB;
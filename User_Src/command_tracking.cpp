@@ -12,6 +12,85 @@
 
 
 
+static_assert(CMD_BUFFER_SIZE < CMD_SLOT_NONE, "slot indeksi uint8_t'ye sigmali");
+static_assert((CMD_ECHO_BUCKETS & (CMD_ECHO_BUCKETS - 1U)) == 0U, "CMD_ECHO_BUCKETS 2'nin kuvveti olmali");
+static_assert(QUERY_MAX <= 32U, "sorgu maskesi 32 bit");
+
+#define QUERY_BIT(q)    (1UL << (uint32_t)(q))
+
+/* Private Fonksiyonlar */
+
+static inline uint8_t echo_bucket(const uint8_t *cam_cmd)
+{
+	return (uint8_t)((cam_cmd[0] ^ (uint8_t)(cam_cmd[1] * 7U) ^ (uint8_t)(cam_cmd[2] * 31U)) & (CMD_ECHO_BUCKETS - 1U));
+}
+
+/* Slotu listenin sonuna ekle (en yeni) */
+static void list_append(cmdRingBuffer_t *ring_buf_ptr, cmdList_t *list_ptr, cmdListKind_t kind, uint8_t slot)
+{
+	cmdLink_t *l = &ring_buf_ptr->link[slot];
+
+	l->prev[kind] = list_ptr->tail;
+	l->next[kind] = CMD_SLOT_NONE;
+	if (list_ptr->tail != CMD_SLOT_NONE) {
+		ring_buf_ptr->link[list_ptr->tail].next[kind] = slot;
+	} else {
+		list_ptr->head = slot;
+	}
+	list_ptr->tail = slot;
+}
+
+/* Slotu listeden cikar (konumu ne olursa olsun) */
+static void list_unlink(cmdRingBuffer_t *ring_buf_ptr, cmdList_t *list_ptr, cmdListKind_t kind, uint8_t slot)
+{
+	const uint8_t prev = ring_buf_ptr->link[slot].prev[kind];
+	const uint8_t next = ring_buf_ptr->link[slot].next[kind];
+
+	if (prev != CMD_SLOT_NONE) {
+		ring_buf_ptr->link[prev].next[kind] = next;
+	} else {
+		list_ptr->head = next;
+	}
+	if (next != CMD_SLOT_NONE) {
+		ring_buf_ptr->link[next].prev[kind] = prev;
+	} else {
+		list_ptr->tail = prev;
+	}
+}
+
+/* Veri bekleyen listede sorgusu query_type olan, eklenebilir en eski kayit */
+static uint8_t query_find(const cmdRingBuffer_t *ring_buf_ptr, queryBitEnum query_type)
+{
+	uint8_t slot = ring_buf_ptr->shape[CMD_RESP_SHAPE_DATA].head;
+
+	while ((slot != CMD_SLOT_NONE) &&
+	       ((ring_buf_ptr->buffer[slot].nmbr != query_type) || (ring_buf_ptr->buffer[slot].joinable == 0U))) {
+		slot = ring_buf_ptr->link[slot].next[CMD_LIST_SHAPE];
+	}
+	return slot;
+}
+
+/* Slotu tum listelerden cikar ve serbest listeye geri ver */
+static void slot_release(cmdRingBuffer_t *ring_buf_ptr, uint8_t slot)
+{
+	cmdBlock_t *block_ptr = &ring_buf_ptr->buffer[slot];
+
+	list_unlink(ring_buf_ptr, &ring_buf_ptr->age, CMD_LIST_AGE, slot);
+	list_unlink(ring_buf_ptr, &ring_buf_ptr->shape[block_ptr->shape], CMD_LIST_SHAPE, slot);
+	if (block_ptr->shape == (uint8_t)CMD_RESP_SHAPE_DATA) {
+		list_unlink(ring_buf_ptr, &ring_buf_ptr->echo[echo_bucket(block_ptr->cam_cmd)], CMD_LIST_ECHO, slot);
+		/* Ayni sorgudan baska kayit kalmadiysa bit temizlenir */
+		if ((block_ptr->nmbr != QUERY_NONE) && (query_find(ring_buf_ptr, block_ptr->nmbr) == CMD_SLOT_NONE)) {
+			ring_buf_ptr->query_mask &= ~QUERY_BIT(block_ptr->nmbr);
+		}
+	}
+
+	ring_buf_ptr->link[slot].prev[CMD_LIST_AGE] = CMD_SLOT_NONE;
+	ring_buf_ptr->link[slot].next[CMD_LIST_AGE] = ring_buf_ptr->free_head;
+	ring_buf_ptr->free_head = slot;
+	ring_buf_ptr->count = ring_buf_ptr->count - 1U;
+}
+
 /* Public Fonksiyonlar */
 
 void CmdRingBuffer_Init (cmdRingBuffer_t *ring_buf_ptr)
@@ -20,58 +99,104 @@ void CmdRingBuffer_Init (cmdRingBuffer_t *ring_buf_ptr)
 	{
 		/*Tüm yapıyı sıfırla*/
 		(void)memset(ring_buf_ptr,0,sizeof(cmdRingBuffer_t));
-		 /* Pointer'lari baslangica al */
-		ring_buf_ptr->head=0U;
-		ring_buf_ptr->tail=0U;
-		ring_buf_ptr->count=0U;
+		CmdRingBuffer_Clear(ring_buf_ptr);
 	}
 }
+bool CmdRingBuffer_MakeBlock(
+    cmdBlock_t *block_ptr,
+    const CtrlPacketView_t *req_view_ptr,
+    queryBitEnum query_type,
+    const void *mapping_ptr,
+    const uint8_t *cam_cmd_ptr,
+    cmdRespShape_t shape)
+{
+    bool result = false;
+
+    /* Parametre kontrolleri */
+    if ((block_ptr != NULL) && (req_view_ptr != NULL) && (mapping_ptr != NULL) &&
+        (cam_cmd_ptr != NULL) && (shape < CMD_RESP_SHAPE_COUNT)) {
+
+        /* Uzunluk sinirlar icinde mi kontrol et */
+        if (req_view_ptr->len <= CMD_MAX_LENGTH) {
+            /* Orjinal istekten sadece yanit icin gereken alanlari al (kopya yok);
+               read komutunda payload yoktur, parametre 0 kalir */
+            block_ptr->ctrl_cmd = (uint8_t)(req_view_ptr->key & 0xFFU);
+            block_ptr->ctrl_key = req_view_ptr->key;
+            block_ptr->ctrl_param = (req_view_ptr->payload_len != 0U) ? req_view_ptr->payload[0] : 0U;
+            block_ptr->request_lenth = req_view_ptr->len;
+            /* Metadata'yi kaydet (zaman Push aninda) */
+            block_ptr->nmbr = query_type;
+            block_ptr->timestamp = 0U;
+            block_ptr->mapping = mapping_ptr;
+            block_ptr->cam_cmd[0] = cam_cmd_ptr[0];
+            block_ptr->cam_cmd[1] = cam_cmd_ptr[1];
+            block_ptr->cam_cmd[2] = cam_cmd_ptr[2];
+            block_ptr->shape = (uint8_t)shape;
+            block_ptr->coalesce = 0U;
+            block_ptr->waiters = 0U;
+            block_ptr->prio = (shape == CMD_RESP_SHAPE_DATA) ? (uint8_t)CMD_PRIO_READ : (uint8_t)CMD_PRIO_INTERACTIVE;
+            block_ptr->joinable = (shape == CMD_RESP_SHAPE_DATA) ? 1U : 0U;
+            result = true;
+        }
+    }
+
+    return result;
+}
+
+bool CmdRingBuffer_PushBlock(
+    cmdRingBuffer_t *ring_buf_ptr,
+    const cmdBlock_t *req_block_ptr)
+{
+    bool result = false;
+    cmdBlock_t *block_ptr;
+    uint8_t slot;
+
+    /* Parametre kontrolleri */
+    if ((ring_buf_ptr != NULL) && (req_block_ptr != NULL) && (req_block_ptr->shape < CMD_RESP_SHAPE_COUNT)) {
+
+        /* Buffer dolu mu kontrol et */
+        if (ring_buf_ptr->free_head != CMD_SLOT_NONE) {
+            /* Bos slot al */
+            slot = ring_buf_ptr->free_head;
+            ring_buf_ptr->free_head = ring_buf_ptr->link[slot].next[CMD_LIST_AGE];
+            block_ptr = &ring_buf_ptr->buffer[slot];
+            (void)memcpy(block_ptr, req_block_ptr, sizeof(cmdBlock_t));
+            block_ptr->timestamp = HAL_GetTick();  /* Suanki zamani al (gonderim ani) */
+
+            /* Indekslere ekle: yas, yanit sekli, veri bekliyorsa echo kovasi */
+            list_append(ring_buf_ptr, &ring_buf_ptr->age, CMD_LIST_AGE, slot);
+            list_append(ring_buf_ptr, &ring_buf_ptr->shape[block_ptr->shape], CMD_LIST_SHAPE, slot);
+            if (block_ptr->shape == (uint8_t)CMD_RESP_SHAPE_DATA) {
+                list_append(ring_buf_ptr, &ring_buf_ptr->echo[echo_bucket(block_ptr->cam_cmd)], CMD_LIST_ECHO, slot);
+                if ((block_ptr->joinable != 0U) && (block_ptr->nmbr != QUERY_NONE) && (block_ptr->nmbr < QUERY_MAX)) {
+                    ring_buf_ptr->query_mask |= QUERY_BIT(block_ptr->nmbr);
+                }
+            } else {
+                /* Set: oncesinde giden ayni parametre okumalari eski degeri dondurur */
+                CmdRingBuffer_CloseReads(ring_buf_ptr, block_ptr);
+            }
+            ring_buf_ptr->count = ring_buf_ptr->count + 1U;
+            result = true;
+        }
+    }
+
+    return result;
+}
+
 bool CmdRingBuffer_PushComplete(
-		cmdRingBuffer_t *ring_buf_ptr,
-//		const uint8_t *expected_resp_ptr,
-//		uint32_t resp_len,
-		const uint8_t *orig_req_ptr,
-		uint32_t req_len,
-		queryBitEnum query_type,
-		const void *mapping_ptr)
-{
-		bool result=false;
-		cmdBlock_t *block_ptr;
-
-		/* parametre kontrolleri*/
-		if((ring_buf_ptr!=nullptr) && (orig_req_ptr != nullptr) && (mapping_ptr !=nullptr))
-
-			/* buffer dolu mu kontrol et*/
-			if(ring_buf_ptr->count < CMD_BUFFER_SIZE)
-			{
-				/*Uzunluk sınırlar içinde mi kontrol et*/
-				if(req_len<=CMD_MAX_LENGTH )
-				{
-					/*Yeni slot'un pointer'ını al */
-					block_ptr=&ring_buf_ptr->buffer[ring_buf_ptr->head];
-					/*Block'u temizle */
-					(void)memset(block_ptr,0,sizeof(cmdBlock_t));
-					/* Beklenen yanıt varsa kopyala*/
-//					if(expected_resp_ptr!=nullptr)
-//					{
-//						(void)memcpy(block_ptr->expected_response, expected_resp_ptr, resp_len);
-//						  block_ptr->response_length = resp_len;
-//					}
-					/* Orjinal istegi kopyala */
-					(void)memcpy(block_ptr->original_request, orig_req_ptr, req_len);
-					block_ptr->request_lenth = req_len;
-	                /* Metadata'yi kaydet */
-	                block_ptr->nmbr = query_type;
-	                block_ptr->timestamp = HAL_GetTick();  /* Suanki zamani al */
-	                block_ptr->mapping = mapping_ptr;
-	                /* Head pointer'i ilerlet (circular) */
-	                ring_buf_ptr->head = (ring_buf_ptr->head + 1U) % CMD_BUFFER_SIZE;
-	                ring_buf_ptr->count = ring_buf_ptr->count + 1U;
-	                result = true;
-				}
-			}
-	    return result;
+    cmdRingBuffer_t *ring_buf_ptr,
+    const CtrlPacketView_t *req_view_ptr,
+    queryBitEnum query_type,
+    const void *mapping_ptr,
+    const uint8_t *cam_cmd_ptr,
+    cmdRespShape_t shape)
+{
+    cmdBlock_t block;
+
+    return CmdRingBuffer_MakeBlock(&block, req_view_ptr, query_type, mapping_ptr, cam_cmd_ptr, shape) &&
+           CmdRingBuffer_PushBlock(ring_buf_ptr, &block);
 }
+
 bool CmdRingBuffer_Pop(
 		cmdRingBuffer_t *ring_buf_ptr,
 		cmdBlock_t *block_ptr)
@@ -85,11 +210,9 @@ bool CmdRingBuffer_Pop(
 		{
 
 			/* En eski entry'yi kopyalaa */
-			(void)memcpy(block_ptr, &ring_buf_ptr->buffer[ring_buf_ptr->tail],
+			(void)memcpy(block_ptr, &ring_buf_ptr->buffer[ring_buf_ptr->age.head],
 					sizeof(cmdBlock_t));
-			 /* Tail pointer'i ilerlet (circular) */
-			ring_buf_ptr->tail= (ring_buf_ptr->tail +1U) &CMD_BUFFER_SIZE;
-			ring_buf_ptr->count=ring_buf_ptr->count -1U;
+			slot_release(ring_buf_ptr, ring_buf_ptr->age.head);
 
 			result=true;
 		}
@@ -111,8 +234,152 @@ bool CmdRingBuffer_Peek(
         if (ring_buf_ptr->count > 0U) {
 
             /* En eski entry'yi kopyala (silme) */
-            (void)memcpy(block_ptr, &ring_buf_ptr->buffer[ring_buf_ptr->tail], sizeof(cmdBlock_t));
+            (void)memcpy(block_ptr, &ring_buf_ptr->buffer[ring_buf_ptr->age.head], sizeof(cmdBlock_t));
+
+            result = true;
+        }
+    }
+
+    return result;
+}
+
+const cmdBlock_t *CmdRingBuffer_Front(const cmdRingBuffer_t *ring_buf_ptr)
+{
+    const cmdBlock_t *result = NULL;
 
+    /* NULL ve bos kontrolu */
+    if ((ring_buf_ptr != NULL) && (ring_buf_ptr->count > 0U)) {
+        result = &ring_buf_ptr->buffer[ring_buf_ptr->age.head];
+    }
+
+    return result;
+}
+
+bool CmdRingBuffer_Drop(cmdRingBuffer_t *ring_buf_ptr)
+{
+    bool result = false;
+
+    /* NULL ve bos kontrolu */
+    if ((ring_buf_ptr != NULL) && (ring_buf_ptr->count > 0U)) {
+
+        slot_release(ring_buf_ptr, ring_buf_ptr->age.head);
+
+        result = true;
+    }
+
+    return result;
+}
+
+const cmdBlock_t *CmdRingBuffer_Match(
+    const cmdRingBuffer_t *ring_buf_ptr,
+    const CamPacketView_t *resp_view_ptr,
+    cmdMatchKind_t *kind_ptr)
+{
+    cmdMatchKind_t kind = CMD_MATCH_NONE;
+    uint8_t slot = CMD_SLOT_NONE;
+    uint8_t status;
+
+    if ((ring_buf_ptr != NULL) && (resp_view_ptr != NULL) && (ring_buf_ptr->count > 0U) &&
+        (resp_view_ptr->body_len != 0U)) {
+
+        status = resp_view_ptr->body[0];
+
+        if (resp_view_ptr->body_len > 1U) {
+            /* Veri yaniti: STATUS B1 B2 B3 ... ise komutun kendisiyle esle */
+            if (resp_view_ptr->body_len >= 4U) {
+                slot = ring_buf_ptr->echo[echo_bucket(&resp_view_ptr->body[1])].head;
+                while ((slot != CMD_SLOT_NONE) &&
+                       (memcmp(ring_buf_ptr->buffer[slot].cam_cmd, &resp_view_ptr->body[1], 3U) != 0)) {
+                    slot = ring_buf_ptr->link[slot].next[CMD_LIST_ECHO];
+                }
+                kind = CMD_MATCH_ECHO;
+            }
+            if (slot == CMD_SLOT_NONE) {
+                slot = ring_buf_ptr->shape[CMD_RESP_SHAPE_DATA].head;
+                kind = CMD_MATCH_SHAPE;
+            }
+        } else if (status == 0x00U) {
+            /* Basarili ACK sadece set komutlarina gelir */
+            slot = ring_buf_ptr->shape[CMD_RESP_SHAPE_ACK].head;
+            kind = CMD_MATCH_SHAPE;
+        }
+
+        /* Belirsiz: NACK ya da bu sekilde bekleyen komut yok */
+        if (slot == CMD_SLOT_NONE) {
+            slot = ring_buf_ptr->age.head;
+            kind = CMD_MATCH_FIFO;
+        }
+    }
+
+    if (kind_ptr != NULL) {
+        *kind_ptr = kind;
+    }
+    return (slot != CMD_SLOT_NONE) ? &ring_buf_ptr->buffer[slot] : NULL;
+}
+
+bool CmdRingBuffer_AttachWaiter(cmdRingBuffer_t *ring_buf_ptr, queryBitEnum query_type)
+{
+    bool result = false;
+    uint8_t slot;
+
+    if ((ring_buf_ptr != NULL) && CmdRingBuffer_IsQueryInFlight(ring_buf_ptr, query_type)) {
+        slot = query_find(ring_buf_ptr, query_type);
+        if ((slot != CMD_SLOT_NONE) && (ring_buf_ptr->buffer[slot].waiters < CMD_READ_WAITERS_MAX)) {
+            ring_buf_ptr->buffer[slot].waiters++;
+            result = true;
+        }
+    }
+
+    return result;
+}
+
+bool CmdRingBuffer_IsQueryInFlight(const cmdRingBuffer_t *ring_buf_ptr, queryBitEnum query_type)
+{
+    return (ring_buf_ptr != NULL) && (query_type != QUERY_NONE) && (query_type < QUERY_MAX) &&
+           ((ring_buf_ptr->query_mask & QUERY_BIT(query_type)) != 0U);
+}
+
+bool CmdBlock_SameParam(const cmdBlock_t *a_ptr, const cmdBlock_t *b_ptr)
+{
+    return (a_ptr->ctrl_key == b_ptr->ctrl_key) ||
+           (memcmp(a_ptr->cam_cmd, b_ptr->cam_cmd, sizeof(a_ptr->cam_cmd)) == 0);
+}
+
+void CmdRingBuffer_CloseReads(cmdRingBuffer_t *ring_buf_ptr, const cmdBlock_t *set_block_ptr)
+{
+    cmdBlock_t *block_ptr;
+    uint8_t slot;
+
+    if ((ring_buf_ptr == NULL) || (set_block_ptr == NULL)) {
+        return;
+    }
+
+    for (slot = ring_buf_ptr->shape[CMD_RESP_SHAPE_DATA].head; slot != CMD_SLOT_NONE;
+         slot = ring_buf_ptr->link[slot].next[CMD_LIST_SHAPE]) {
+        block_ptr = &ring_buf_ptr->buffer[slot];
+        if ((block_ptr->joinable != 0U) && CmdBlock_SameParam(block_ptr, set_block_ptr)) {
+            block_ptr->joinable = 0U;
+            if ((block_ptr->nmbr != QUERY_NONE) && (block_ptr->nmbr < QUERY_MAX) &&
+                (query_find(ring_buf_ptr, block_ptr->nmbr) == CMD_SLOT_NONE)) {
+                ring_buf_ptr->query_mask &= ~QUERY_BIT(block_ptr->nmbr);
+            }
+        }
+    }
+}
+
+bool CmdRingBuffer_Remove(cmdRingBuffer_t *ring_buf_ptr, const cmdBlock_t *block_ptr)
+{
+    bool result = false;
+    uint32_t slot;
+
+    if ((ring_buf_ptr != NULL) && (block_ptr != NULL) &&
+        (block_ptr >= &ring_buf_ptr->buffer[0]) && (block_ptr < &ring_buf_ptr->buffer[CMD_BUFFER_SIZE])) {
+
+        slot = (uint32_t)(block_ptr - &ring_buf_ptr->buffer[0]);
+
+        /* Bos slot serbest listededir, yas listesinde degil */
+        if ((ring_buf_ptr->link[slot].prev[CMD_LIST_AGE] != CMD_SLOT_NONE) || (ring_buf_ptr->age.head == slot)) {
+            slot_release(ring_buf_ptr, (uint8_t)slot);
             result = true;
         }
     }
@@ -158,21 +425,30 @@ uint32_t CmdRingBuffer_Size(const cmdRingBuffer_t *ring_buf_ptr)
 
 void CmdRingBuffer_Clear(cmdRingBuffer_t *ring_buf_ptr)
 {
+    uint8_t i;
+
     /* NULL kontrolu */
     if (ring_buf_ptr != NULL) {
 
-        /* Pointer'lari sifirla */
-        ring_buf_ptr->head = 0U;
-        ring_buf_ptr->tail = 0U;
-        ring_buf_ptr->count = 0U;
-
         /* Buffer icerigini temizle */
         (void)memset(ring_buf_ptr->buffer, 0, sizeof(ring_buf_ptr->buffer));
+        (void)memset(ring_buf_ptr->link, CMD_SLOT_NONE, sizeof(ring_buf_ptr->link));
+        (void)memset(&ring_buf_ptr->age, CMD_SLOT_NONE, sizeof(ring_buf_ptr->age));
+        (void)memset(ring_buf_ptr->shape, CMD_SLOT_NONE, sizeof(ring_buf_ptr->shape));
+        (void)memset(ring_buf_ptr->echo, CMD_SLOT_NONE, sizeof(ring_buf_ptr->echo));
+
+        /* Tum slotlar serbest listede */
+        for (i = 0U; i < CMD_BUFFER_SIZE; i++) {
+            ring_buf_ptr->link[i].next[CMD_LIST_AGE] = ((i + 1U) < CMD_BUFFER_SIZE) ? (uint8_t)(i + 1U) : CMD_SLOT_NONE;
+        }
+        ring_buf_ptr->free_head = 0U;
+        ring_buf_ptr->count = 0U;
+        ring_buf_ptr->query_mask = 0U;
     }
 }
 
 
-bool CmdRingBuffer_RemoveIfTimeout(
+bool CmdRingBuffer_RemoveIfTimeOut(
     cmdRingBuffer_t *ring_buf_ptr,
     uint32_t timeout_ms,
     uint32_t current_time)
@@ -188,7 +464,7 @@ bool CmdRingBuffer_RemoveIfTimeout(
         if (ring_buf_ptr->count > 0U) {
 
             /* En eski komutun zamanini al */
-            oldest_timestamp = ring_buf_ptr->buffer[ring_buf_ptr->tail].timestamp;
+            oldest_timestamp = ring_buf_ptr->buffer[ring_buf_ptr->age.head].timestamp;
 
             /* Gecen zamani hesapla (uint32_t wraparound'u otomatik hallolur) */
             elapsed_time = current_time - oldest_timestamp;
@@ -196,9 +472,8 @@ bool CmdRingBuffer_RemoveIfTimeout(
             /* Timeout asildi mi kontrol et */
             if (elapsed_time >= timeout_ms) {
 
-                /* En eski komutu kaldir */
-                ring_buf_ptr->tail = (ring_buf_ptr->tail + 1U) % CMD_BUFFER_SIZE;
-                ring_buf_ptr->count = ring_buf_ptr->count - 1U;
+                /* En eski komutu kaldir (indekslerden de) */
+                slot_release(ring_buf_ptr, ring_buf_ptr->age.head);
 
                 result = true;
             }
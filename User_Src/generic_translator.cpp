@@ -1,151 +1,375 @@
 /**
- * @file generic_translator.c
- * @brief Metadata-driven generic translator
+ * @file generic_translator.cpp
+ * @brief Flash tablosundan (bytecode) kontrol -> kamera cevirisi
  *
- * Use: create CommandMetadata_t entries per command, then call
- * GenericTranslator_FromMetadata(meta, ctrl_pkt, ctrl_len, cam_buf, &cam_len).
+ * Yukleme (CmdTab_Load) imaji bir kez dogrular: CRC, her kaydin alanlari ve
+ * bytecode'u adim adim yurunerek opcode/operand araliklari, kamera paketi boyu
+ * ve gereken kontrol paketi boyu. Sabit bytelarin XOR katkisi da burada
+ * hesaplanir. Gecerli kayitlar RAM indeksine siralanir.
  *
- * This produces camera packet: 55 AA [LEN] B1 B2 B3 [payload..] [XOR] F0
+ * Yorumlayici (CmdTab_Translate) opcode -> etiket tablosu ile dogrudan
+ * atlayarak (threaded dispatch, GCC computed goto) calisir; dogrulanmis kodda
+ * opcode, operand ve cikti siniri tekrar kontrol edilmez.
+ *
+ * Format: commands_metadata.h, assembler: Tools/cmdtab_asm.py
  */
 
 #include "commands_metadata.h"
-#include "command_handler.h" /* for CAM_PKT_START*, CAM_PKT_END definitions */
+#include "translator_dsl.h"     /* TR_CAM_PKT_MAX, TR_CTRL_TAIL_SIZE */
 #include <string.h>
-#include <stdint.h>
-#include <stdbool.h>
 
+/* Linker: CMDTAB bolgesi (STM32L432KBUX_FLASH.ld) */
+extern "C" const uint8_t _scmd_table[];
+extern "C" const uint8_t _ecmd_table[];
+
+/* Kamera basligi (55 AA LEN B1 B2 B3) + trailer (XOR F0) */
+#define CMDTAB_CAM_HEAD_SIZE    (6U)
+#define CMDTAB_CAM_PAYLOAD_MAX  (TR_CAM_PKT_MAX - CMDTAB_CAM_HEAD_SIZE - 2U)
+
+/* Imaj formati: Tools/cmdtab_asm.py ile ayni yerlesim */
+static_assert(sizeof(CmdTabHeader_t) == 16U, "CmdTabHeader_t 16 byte olmali");
+static_assert(sizeof(CmdTabEntry_t) == 14U, "CmdTabEntry_t 14 byte olmali");
+
+/* Opcode basina sabit boy (LOOKUP tablosu haric) */
+static const uint8_t cmdtab_op_size[PAYACT_COUNT] = { 1U, 3U, 3U, 5U, 4U };
+
+static CmdTabCommand_t cmdtab_index[CMDTAB_MAX_ENTRIES];
+static uint8_t cmdtab_count;
+static CmdTabStatus_t cmdtab_status = CMDTAB_EMPTY;
 
 
-/* Helper: write camera header */
-static uint8_t write_cam_header(uint8_t *buf, uint8_t b1, uint8_t b2, uint8_t b3)
+/* IEEE 802.3 CRC32 (yansitilmis, 0xEDB88320). Sadece yuklemede calisir. */
+static uint32_t cmdtab_crc32(const uint8_t *data, uint32_t len)
 {
-    uint8_t idx = 0U;
-    buf[idx++] = CAM_PKT_START1; /* 0x55 */
-    buf[idx++] = CAM_PKT_START2; /* 0xAA */
-    buf[idx++] = 0x00U;          /* LEN placeholder */
-    buf[idx++] = b1;
-    buf[idx++] = b2;
-    buf[idx++] = b3;
-    return idx; /* current index */
+    uint32_t crc = 0xFFFFFFFFUL;
+
+    for (uint32_t i = 0U; i < len; i++) {
+        crc ^= data[i];
+        for (uint8_t b = 0U; b < 8U; b++) {
+            crc = (crc >> 1U) ^ (0xEDB88320UL & (0UL - (crc & 1UL)));
+        }
+    }
+    return ~crc;
 }
 
-/* Helper: scale 8-bit value (simple integer scaling) */
-static uint8_t scale8(uint8_t v, uint8_t mul, uint8_t div)
+static uint32_t cmdtab_order(uint8_t kb0, uint8_t kb1, uint8_t type, uint16_t match)
 {
-//    if (div == 0U) { return v; }
-//    uint32_t r = (uint32_t)v * (uint32_t)mul;
-//    r = r / (uint32_t)div;
-//    if (r > 0xFFU) { r = 0xFFU; }
-//    return (uint8_t)r;
+    return ((uint32_t)MAKE_CTRL_KEY(kb0, kb1) << 16U) | ((uint32_t)type << 9U) | (uint32_t)match;
 }
 
-/* Generic translator implementation */
-bool GenericTranslator_FromMetadata(
-    const CommandMetadata_t *meta,
-    const uint8_t *ctrl_packet,
-    uint8_t ctrl_len,
-    uint8_t *cam_packet,
-    uint8_t *cam_len)
+/* Bir kaydin kodunu yuru: opcode/operand gecerli mi, cikti ve kontrol boyu */
+static bool cmdtab_check_code(const uint8_t *code, uint16_t code_size, uint16_t off, CmdTabCommand_t *cmd)
 {
-    if ((meta == NULL) || (ctrl_packet == NULL) || (cam_packet == NULL) || (cam_len == NULL)) {
-        return false;
-    }
+    uint32_t pc = off;
+    uint32_t payload = 0U;
+    uint32_t min_ctrl = CTRL_PKT_MIN_SIZE;
+    uint8_t x = 0U;
 
-    uint8_t idx = write_cam_header(cam_packet, meta->cam_b1, meta->cam_b2, meta->cam_b3);
+    for (;;) {
+        uint32_t need;
+        uint32_t src_end = 0U;
+        uint8_t n = 0U;
 
-    /* Apply payload steps */
-    for (uint8_t si = 0U; si < meta->step_count; si++) {
-        const payload_step_t *step = &meta->steps[si];
+        if ((pc >= code_size) || (code[pc] >= (uint8_t)PAYACT_COUNT)) {
+            return false;
+        }
+        need = cmdtab_op_size[code[pc]];
+        if ((pc + need) > code_size) {
+            return false;
+        }
 
-        switch (step->action) {
-        case PAYACT_NOP:
-            /* nothing */
-            break;
+        switch ((payload_action_t)code[pc]) {
+        case PAYACT_END:
+            cmd->len_field = (uint8_t)(3U + payload);
+            cmd->head_xor = (uint8_t)(x ^ cmd->len_field ^ cmd->cam_cmd[0] ^ cmd->cam_cmd[1] ^ cmd->cam_cmd[2]);
+            cmd->min_ctrl = (uint8_t)min_ctrl;
+            return true;
 
         case PAYACT_CONST:
-            /* write 'length' copies of const_value */
-            for (uint8_t k = 0U; k < step->length; k++) {
-                cam_packet[idx++] = step->const_value;
+            n = code[pc + 1U];
+            if ((n & 1U) != 0U) {
+                x ^= code[pc + 2U];     /* sabit: XOR'a yuklemede katilir */
             }
             break;
 
         case PAYACT_COPY:
-            /* copy length bytes from ctrl_packet[src_offset] */
-            if ((uint32_t)step->src_offset + step->length > (uint32_t)ctrl_len) {
-                /* out-of-bounds */
-                return false;
-            }
-            memcpy(&cam_packet[idx], &ctrl_packet[step->src_offset], step->length);
-            idx = (uint8_t)(idx + step->length);
+            n = code[pc + 2U];
+            src_end = (uint32_t)code[pc + 1U] + n;
             break;
 
         case PAYACT_SCALE8:
-            /* read one byte from ctrl, scale it, write length bytes (usually 1) */
-            if ((uint32_t)step->src_offset >= (uint32_t)ctrl_len) { return false; }
-            {
-                uint8_t v = ctrl_packet[step->src_offset];
-                uint8_t out = scale8(v, step->scale_mul, step->scale_div);
-                for (uint8_t k = 0U; k < step->length; k++) {
-                    cam_packet[idx++] = out;
-                }
+            n = code[pc + 4U];
+            if (code[pc + 3U] == 0U) {
+                return false;
             }
+            src_end = (uint32_t)code[pc + 1U] + 1U;
             break;
 
         case PAYACT_LOOKUP:
-            /* read one index and lookup */
-            if ((uint32_t)step->src_offset >= (uint32_t)ctrl_len) { return false; }
-            {
-                uint8_t idx_in = ctrl_packet[step->src_offset];
-                if (idx_in >= step->lookup_len) { return false; }
-                uint8_t outv = step->lookup[idx_in];
-                for (uint8_t k = 0U; k < step->length; k++) {
-                    cam_packet[idx++] = outv;
-                }
+            n = code[pc + 2U];
+            if (code[pc + 3U] == 0U) {
+                return false;
             }
+            need += code[pc + 3U];
+            if ((pc + need) > code_size) {
+                return false;
+            }
+            src_end = (uint32_t)code[pc + 1U] + 1U;
             break;
 
         default:
             return false;
         }
-    }
-
-/* Fill LEN field: number of bytes from index 2 up to and including checksum */
-	if (idx < 3U) { return false; }
-	cam_packet[2] = (uint8_t)(idx - 2U);
-
-	/* Compute XOR over bytes index 2..idx-1 */
-	uint8_t xorv = 0U;
-	for (uint8_t i = 2U; i < idx; i++) { xorv ^= cam_packet[i]; }
-
-	cam_packet[idx++] = xorv;
-	cam_packet[idx++] = CAM_PKT_END;
 
-	*cam_len = idx;
-	return true;
+        if (n == 0U) {
+            return false;
+        }
+        payload += n;
+        if (payload > CMDTAB_CAM_PAYLOAD_MAX) {
+            return false;
+        }
+        if ((src_end + TR_CTRL_TAIL_SIZE) > min_ctrl) {
+            min_ctrl = src_end + TR_CTRL_TAIL_SIZE;
+            if (min_ctrl > 0xFFU) {
+                return false;
+            }
+        }
+        pc += need;
+    }
 }
 
+CmdTabStatus_t CmdTab_Load(const uint8_t *image, uint32_t region_size)
+{
+    CmdTabHeader_t hdr;
+    const CmdTabEntry_t *entries;
+    const uint8_t *code;
+    uint32_t body_size;
 
+    cmdtab_count = 0U;
 
+    if ((image == NULL) || (region_size < sizeof(CmdTabHeader_t))) {
+        cmdtab_status = CMDTAB_BAD_HEADER;
+        return cmdtab_status;
+    }
+    memcpy(&hdr, image, sizeof(hdr));
 
+    if (hdr.magic == 0xFFFFFFFFUL) {
+        cmdtab_status = CMDTAB_EMPTY;
+        return cmdtab_status;
+    }
+    body_size = (uint32_t)hdr.entry_count * sizeof(CmdTabEntry_t) + hdr.code_size;
+    if ((hdr.magic != CMDTAB_MAGIC) || (hdr.version != CMDTAB_VERSION) ||
+        (hdr.entry_count > CMDTAB_MAX_ENTRIES) ||
+        ((sizeof(CmdTabHeader_t) + body_size) > region_size)) {
+        cmdtab_status = CMDTAB_BAD_HEADER;
+        return cmdtab_status;
+    }
+    if (cmdtab_crc32(image + sizeof(CmdTabHeader_t), body_size) != hdr.crc32) {
+        cmdtab_status = CMDTAB_BAD_CRC;
+        return cmdtab_status;
+    }
 
+    entries = (const CmdTabEntry_t *)(const void *)(image + sizeof(CmdTabHeader_t));
+    code = (const uint8_t *)(entries + hdr.entry_count);
+
+    for (uint16_t i = 0U; i < hdr.entry_count; i++) {
+        CmdTabEntry_t e;
+        CmdTabCommand_t cmd;
+        uint8_t pos;
+
+        memcpy(&e, &entries[i], sizeof(e));
+        /* Birlestirme sadece parametre ayari olan set'te anlamlidir */
+        if ((e.type > (uint8_t)CMD_TYPE_READ) || (e.match_kind > (uint8_t)CMD_MATCH_P0) ||
+            (e.query_id >= (uint8_t)QUERY_MAX) || (e.resp >= (uint8_t)CMDTAB_RESP_COUNT) ||
+            (e.prio >= (uint8_t)CMD_PRIO_COUNT) || ((e.flags & ~CMDTAB_FLAG_COALESCE) != 0U) ||
+            (((e.flags & CMDTAB_FLAG_COALESCE) != 0U) && (e.type != (uint8_t)CMD_TYPE_SET))) {
+            cmdtab_count = 0U;
+            cmdtab_status = CMDTAB_BAD_ENTRY;
+            return cmdtab_status;
+        }
 
+        cmd.order = cmdtab_order(e.kb0, e.kb1, e.type,
+                                 (e.match_kind == (uint8_t)CMD_MATCH_P0) ? e.match_value : 256U);
+        cmd.code = &code[e.code_off];
+        cmd.cam_cmd[0] = e.cam_cmd[0];
+        cmd.cam_cmd[1] = e.cam_cmd[1];
+        cmd.cam_cmd[2] = e.cam_cmd[2];
+        cmd.query_id = e.query_id;
+        cmd.resp = e.resp;
+        cmd.prio = e.prio;
+        cmd.coalesce = ((e.flags & CMDTAB_FLAG_COALESCE) != 0U) ? 1U : 0U;
+        if (!cmdtab_check_code(code, hdr.code_size, e.code_off, &cmd)) {
+            cmdtab_count = 0U;
+            cmdtab_status = CMDTAB_BAD_CODE;
+            return cmdtab_status;
+        }
 
+        /* Siralayarak ekle (insertion), ayni order ikinci kez gelemez */
+        pos = cmdtab_count;
+        while ((pos > 0U) && (cmdtab_index[pos - 1U].order >= cmd.order)) {
+            if (cmdtab_index[pos - 1U].order == cmd.order) {
+                cmdtab_count = 0U;
+                cmdtab_status = CMDTAB_DUPLICATE;
+                return cmdtab_status;
+            }
+            cmdtab_index[pos] = cmdtab_index[pos - 1U];
+            pos--;
+        }
+        cmdtab_index[pos] = cmd;
+        cmdtab_count++;
+    }
 
+    cmdtab_status = CMDTAB_OK;
+    return cmdtab_status;
+}
 
+CmdTabStatus_t CmdTab_LoadFromFlash(void)
+{
+    return CmdTab_Load(_scmd_table, (uint32_t)(_ecmd_table - _scmd_table));
+}
 
+CmdTabStatus_t CmdTab_GetStatus(void)
+{
+    return cmdtab_status;
+}
 
+uint8_t CmdTab_GetCount(void)
+{
+    return cmdtab_count;
+}
 
+const CmdTabCommand_t *CmdTab_GetCommand(uint8_t index)
+{
+    return (index < cmdtab_count) ? &cmdtab_index[index] : (const CmdTabCommand_t *)0;
+}
 
+static const CmdTabCommand_t *cmdtab_find(uint32_t order)
+{
+    uint8_t lo = 0U;
+    uint8_t hi = cmdtab_count;
+
+    while (lo < hi) {
+        const uint8_t mid = (uint8_t)((lo + hi) >> 1U);
+        if (cmdtab_index[mid].order == order) {
+            return &cmdtab_index[mid];
+        } else if (cmdtab_index[mid].order < order) {
+            lo = (uint8_t)(mid + 1U);
+        } else {
+            hi = mid;
+        }
+    }
+    return (const CmdTabCommand_t *)0;
+}
 
+const CmdTabCommand_t *CmdTab_FindForCtrlPacket(const CtrlPacketView_t *ctrl_view_ptr)
+{
+    const CmdTabCommand_t *cmd = (const CmdTabCommand_t *)0;
+    uint8_t kb0;
+    uint8_t kb1;
+    uint8_t type;
 
+    if ((cmdtab_count == 0U) || (ctrl_view_ptr == NULL) || !ctrl_view_ptr->checksum_ok) {
+        return (const CmdTabCommand_t *)0;
+    }
+    kb0 = (uint8_t)(ctrl_view_ptr->key >> 8U);
+    kb1 = (uint8_t)(ctrl_view_ptr->key & 0xFFU);
+
+    if (ctrl_view_ptr->reserve == CTRL_PKT_RESERVE_SET) {
+        type = (uint8_t)CMD_TYPE_SET;
+    } else if (ctrl_view_ptr->reserve == CTRL_PKT_RESERVE_READ) {
+        type = (uint8_t)CMD_TYPE_READ;
+    } else {
+        return (const CmdTabCommand_t *)0;
+    }
 
+    /* read paketinde payload yok, P0'a bakilmaz */
+    if (ctrl_view_ptr->payload_len != 0U) {
+        cmd = cmdtab_find(cmdtab_order(kb0, kb1, type, ctrl_view_ptr->payload[0U]));
+    }
+    if (cmd == (const CmdTabCommand_t *)0) {
+        cmd = cmdtab_find(cmdtab_order(kb0, kb1, type, 256U));
+    }
+    return cmd;
+}
 
+bool CmdTab_Translate(const CmdTabCommand_t *cmd,
+                      const CtrlPacketView_t *ctrl_view_ptr,
+                      uint8_t *cam_packet_ptr, uint8_t *cam_len_ptr)
+{
+    /* Siralama payload_action_t ile ayni olmali */
+    static const void *const dispatch[PAYACT_COUNT] = {
+        &&op_end, &&op_const, &&op_copy, &&op_scale8, &&op_lookup
+    };
+    const uint8_t *ctrl_packet_ptr;
+    const uint8_t *pc;
+    const uint8_t *src;
+    uint8_t *out;
+    uint8_t x;
+    uint8_t n;
+    uint8_t v;
+
+    if ((cmd == NULL) || (ctrl_view_ptr == NULL) || (cam_packet_ptr == NULL) ||
+        (cam_len_ptr == NULL) || (ctrl_view_ptr->len < cmd->min_ctrl)) {
+        return false;
+    }
+    ctrl_packet_ptr = ctrl_view_ptr->bytes;
+
+    cam_packet_ptr[0] = CAM_PKT_START1;
+    cam_packet_ptr[1] = CAM_PKT_START2;
+    cam_packet_ptr[2] = cmd->len_field;
+    cam_packet_ptr[3] = cmd->cam_cmd[0];
+    cam_packet_ptr[4] = cmd->cam_cmd[1];
+    cam_packet_ptr[5] = cmd->cam_cmd[2];
+    out = &cam_packet_ptr[CMDTAB_CAM_HEAD_SIZE];
+    x = cmd->head_xor;
+    pc = cmd->code;
+
+    goto *dispatch[*pc];
+
+op_const:
+    n = pc[1];
+    v = pc[2];
+    pc += 3;
+    do { *out++ = v; } while (--n != 0U);
+    goto *dispatch[*pc];
+
+op_copy:
+    src = &ctrl_packet_ptr[pc[1]];
+    n = pc[2];
+    pc += 3;
+    do { v = *src++; *out++ = v; x ^= v; } while (--n != 0U);
+    goto *dispatch[*pc];
+
+op_scale8:
+    {
+        const uint32_t r = ((uint32_t)ctrl_packet_ptr[pc[1]] * pc[2]) / pc[3];
+        v = (r > 0xFFU) ? 0xFFU : (uint8_t)r;
+    }
+    n = pc[4];
+    pc += 5;
+    if ((n & 1U) != 0U) {
+        x ^= v;
+    }
+    do { *out++ = v; } while (--n != 0U);
+    goto *dispatch[*pc];
 
-
-
-
-
-
-
-
-
+op_lookup:
+    v = ctrl_packet_ptr[pc[1]];
+    if (v >= pc[3]) {
+        return false;           /* veri bagimli: tablo disi indeks */
+    }
+    v = pc[4U + v];
+    n = pc[2];
+    pc += 4U + pc[3];
+    if ((n & 1U) != 0U) {
+        x ^= v;
+    }
+    do { *out++ = v; } while (--n != 0U);
+    goto *dispatch[*pc];
+
+op_end:
+    *out++ = x;
+    *out++ = CAM_PKT_END;
+    *cam_len_ptr = (uint8_t)(out - cam_packet_ptr);
+    return true;
+}
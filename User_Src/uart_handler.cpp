@@ -2,268 +2,976 @@
  * @file uart_handler.c
  * @brief UART receive state machines and forwarding between control and camera
  *
- * - HAL tarafindan tek-bayt RTC kullanilarak DMA/IT ile calisacak sekilde yazildi.
- * - main.c icindeki HAL_UART_RxCpltCallback fonksiyonundan
- *   UART_Handler_RxCplt(huart) cagrilmasi gerekir (aciklama asagida).
- *
- * Not: Bu implementasyon basit, güvenilir. Performans icin DMA/IDLE vs RX FIFO
- * secenekleri daha verimli olabilir.
+ * - Alim DMA dairesel tampon + USART IDLE ile yapilir (HAL_UARTEx_ReceiveToIdle_DMA).
+ *   Yarim transfer, tam transfer ve IDLE olaylarinda DMA'nin yazdigi yeni
+ *   bytelar tek seferde framer'a verilir; byte basina kesme yoktur.
+ * - UART_DRIVER_LL == 1 ile alim register seviyesine gecer: USART IRQ'su
+ *   RDR'yi dogrudan okuyup ayni halkaya yazar ve framer'a verir (HAL'siz).
+ * - app.cpp icindeki HAL_UARTEx_RxEventCallback fonksiyonundan
+ *   UART_Handler_RxEvent(huart, pos) cagrilmasi gerekir.
+ * - Gonderim port basina DMA kuyrugu ile yapilir; UART_SendTo* hemen doner,
+ *   HAL_UART_TxCpltCallback -> UART_Handler_TxCplt bir sonraki frame'i baslatir.
+ * - Framer bytelari kopyalamaz: frame, DMA halkasi uzerinde (seq, len) ile
+ *   tanimlanir (FrameView_t). ISR sadece gorunumu kuyruga birakir; dogrulama,
+ *   ceviri ve gonderim ana dongude UART_Handler_Process icinde, bytelar
+ *   halkada durdugu yerden okunarak yapilir.
+ * - Frame sonu/kopuklugu donanimda USART receiver timeout (RTOR/RTOF) ile
+ *   algilanir; USART IRQ'su UART_Handler_RxTimeout'u cagirir, yarim frame atilir.
+ * - Framer trailer ve checksum'i kendisi kontrol eder; checksum byte geldikce
+ *   artimli tutulur, CS/XOR byte'i geldiginde tek karsilastirma yapilir (frame
+ *   sonunda halka tekrar taranmaz). Gecersiz adayda
+ *   alinmis bytelari bir sonraki baslangic icin yeniden tarar (resync).
+ *   Ana dongu tam frame'den dogrulanmis gorunumu (CtrlPacketView_t /
+ *   CamPacketView_t) bir kez kurar; sonraki asamalar frame'i tekrar dogrulamaz.
  */
 
 #include "uart_handler.h"
 #include "command_handler.h"
 #include "command_tracking.h"
 #include "packet_builder.h"
+#include "cam_scheduler.h"
 #include "main.h"   /* huart1/huart2 extern tanimi ve HAL_GetTick */
 #include <string.h>
 #include <stdbool.h>
 
 
-/* Local receive byte holders (IT ile tek byte olarak alinir) */
-static uint8_t ctrl_rx_byte;
-static uint8_t cam_rx_byte;
-/* Control receive buffer ve indeksler */
-static uint8_t control_rx_buf[CONTROL_RX_BUFFER_SIZE];
-static uint16_t control_rx_len;
-
-/* Camera receive buffer ve indeksler */
-static uint8_t camera_rx_buf[CAMERA_RX_BUFFER_SIZE];
-static uint16_t camera_rx_len;
+#define UART_RX_RING_MASK  (UART_RX_DMA_BUFFER_SIZE - 1U)
+
+static_assert((UART_RX_DMA_BUFFER_SIZE & UART_RX_RING_MASK) == 0U,
+              "UART_RX_DMA_BUFFER_SIZE 2'nin kuvveti olmali");
+static_assert((UART_RX_FRAME_QUEUE_DEPTH & (UART_RX_FRAME_QUEUE_DEPTH - 1U)) == 0U,
+              "UART_RX_FRAME_QUEUE_DEPTH 2'nin kuvveti olmali");
+static_assert(CAMERA_RX_BUFFER_SIZE <= (UART_RX_DMA_BUFFER_SIZE / 2U),
+              "Frame boyu halkanin yarisini gecmemeli");
+static_assert((CAMERA_RX_BUFFER_SIZE + UART_RX_COPY_MARGIN) < UART_RX_DMA_BUFFER_SIZE,
+              "UART_RX_COPY_MARGIN halkaya sigmali");
+static_assert(CMD_READ_WAITERS_MAX < UART_TX_QUEUE_DEPTH,
+              "Tek ucus yanit kopyalari bos kontrol TX kuyruguna sigmali");
+
+/* Port basina alim durumu.
+   - ring: DMA'nin dairesel yazdigi tampon (frame'ler burada kalir)
+   - dma_pos/total: framer'a verilen son ring pozisyonu ve toplam byte sayisi
+   - start/len/expected: su an toplanan aday frame (mutlak sira + boy)
+   - csum: adayin byte geldikce guncellenen checksum'i (kontrol: toplam,
+     kamera: XOR); frame sonunda tek karsilastirma yapilir
+   - frames: ISR (uretici) -> ana dongu (tuketici) gorunum kuyrugu; head sadece
+     ISR, tail sadece ana dongu tarafindan yazilir (serbest sayan indeksler) */
+typedef struct {
+    UART_HandleTypeDef *huart;
+    uint32_t gap_bits;  /* frame ici en uzun bosluk (bit suresi, USART RTOR) */
+    uint8_t ring[UART_RX_DMA_BUFFER_SIZE];
+    uint16_t dma_pos;
+    volatile uint32_t total;
+    uint32_t start;
+    uint16_t len;
+    uint16_t expected;
+    uint8_t csum;
+    FrameView_t frames[UART_RX_FRAME_QUEUE_DEPTH];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+    uint32_t dropped;   /* kuyruk dolu oldugu icin atilan */
+    uint32_t stale;     /* islenemeden DMA tarafindan uzerine yazilan */
+    uint32_t wrapped;   /* halka sonunda bolundugu icin dogrusallastirilan */
+    uint32_t copied;    /* yazma ucuna yakin oldugu icin islemeden once kopyalanan */
+    uint32_t resyncs;   /* gecersiz aday sonrasi yeniden tarama sayisi */
+    uint32_t gap_aborts;/* hat bosta kaldigi icin birakilan yarim frame */
+    UartIrqStats_t irq_stats;
+    UartErrorStats_t errors;  /* frames_dropped getter'da dropped + stale'den doldurulur */
+} uart_rx_port_t;
+
+/* Framer adim sonucu */
+typedef enum {
+    FRAMER_IDLE = 0U,   /* aday yok / frame tamamlandi */
+    FRAMER_BUSY,        /* aday frame toplaniyor */
+    FRAMER_RESYNC       /* aday gecersiz: baslangictan sonrasi yeniden taranmali */
+} framer_status_t;
+
+typedef framer_status_t (*framer_step_t)(uart_rx_port_t *p, uint8_t b, uint32_t seq);
+
+static uart_rx_port_t rx_port[UART_PORT_COUNT] = {
+    { &vehicle_uart, CONTROL_RX_GAP_BITS },
+    { &cam_uart, CAMERA_RX_GAP_BITS }
+};
+
+/* Port basina DMA gonderim kuyrugu. Frame'ler slot'lara kopyalanir (sabit
+   flash frame'leri kopyalanmaz, data[] dogrudan onu gosterir),
+   desc[] ile sirayla DMA'ya verilir. head/tail/count kesme ile paylasilir. */
+typedef struct {
+    UART_HandleTypeDef *huart;
+    const uint8_t *data[UART_TX_QUEUE_DEPTH];
+    uint16_t len[UART_TX_QUEUE_DEPTH];
+    uint8_t slot[UART_TX_QUEUE_DEPTH][UART_TX_SLOT_SIZE];
+    volatile uint8_t head;
+    volatile uint8_t tail;
+    volatile uint8_t count;
+    volatile bool busy;          /* DMA aktif */
+    uint8_t peak;
+    uint32_t dropped;
+    UartTxCompleteCb_t on_complete;
+} uart_tx_queue_t;
+
+static uart_tx_queue_t tx_queue[UART_PORT_COUNT] = {
+    { &vehicle_uart },
+    { &cam_uart }
+};
+
+/* Tek ucus okumasinda kontrol TX kuyruguna o an sigmayan yanit kopyalari.
+   Yanitlar gelis sirasiyla bekler; her ana dongu turunun basinda ve yeni
+   yanittan once kuyrugun kabul ettigi kadari gonderilir. Alim (RX) bosaltmasi
+   bunu beklemez. */
+#define CTRL_FANOUT_DEPTH   (UART_RX_FRAME_QUEUE_DEPTH)
+
+typedef struct {
+    const uint8_t *frame;       /* sabit (flash) frame ya da bytes[] */
+    uint8_t bytes[UART_TX_SLOT_SIZE];
+    uint8_t len;
+    uint8_t left;               /* gonderilecek kopya */
+} ctrl_fanout_item_t;
+
+typedef struct {
+    ctrl_fanout_item_t items[CTRL_FANOUT_DEPTH];
+    uint8_t head;               /* serbest sayan indeksler, sadece ana dongu */
+    uint8_t tail;
+    uint32_t dropped;           /* sira dolu oldugu icin atilan yanit kopyasi */
+} ctrl_fanout_t;
+
+static_assert((CTRL_FANOUT_DEPTH & (CTRL_FANOUT_DEPTH - 1U)) == 0U,
+              "CTRL_FANOUT_DEPTH 2'nin kuvveti olmali");
+
+static ctrl_fanout_t ctrl_fanout;
 
 /* Forward declarations for local helpers */
-static void control_rx_put_byte(uint8_t b);
-static void camera_rx_put_byte(uint8_t b);
-static void reset_control_buffer(void);
-static void reset_camera_buffer(void);
+static framer_status_t control_rx_step(uart_rx_port_t *p, uint8_t b, uint32_t seq);
+static framer_status_t camera_rx_step(uart_rx_port_t *p, uint8_t b, uint32_t seq);
+static void framer_feed(uart_rx_port_t *p, framer_step_t step, uint32_t seq);
+static void reset_framer(uart_rx_port_t *p);
+static void rx_dma_start(uart_rx_port_t *p);
+static void rx_gap_start(uart_rx_port_t *p);
+static void rx_gap_abort(uart_rx_port_t *p);
+static void rx_error_account(uart_rx_port_t *p, uint32_t error_code);
+static framer_step_t rx_step_of(const uart_rx_port_t *p);
+static uart_rx_port_t *rx_port_of(const UART_HandleTypeDef *huart);
+static void rx_dma_consume(uart_rx_port_t *p, uint16_t pos, framer_step_t step);
+static uint32_t rx_dma_written(const uart_rx_port_t *p);
+static bool tx_enqueue(uart_tx_queue_t *q, const uint8_t *data, uint16_t len, bool copy);
+static void tx_start_next(uart_tx_queue_t *q);
+static uart_tx_queue_t *tx_queue_of(const UART_HandleTypeDef *huart);
+static void rx_frame_push(uart_rx_port_t *p);
+static void rx_frame_drain(uart_rx_port_t *p, void (*handle)(const uint8_t *, uint16_t));
+static void rx_control_frame(const uint8_t *pkt, uint16_t len);
+static void rx_camera_frame(const uint8_t *pkt, uint16_t len);
+static void ctrl_fanout_flush(void);
 
 
 void UART_Handler_Init(void)
 {
-    /* Bufferleri sifirla */
-    reset_control_buffer();
-    reset_camera_buffer();
-
-    /* Baslangicta UART IT ile 1 byte alma islemlerini baslat.
-       Burada huart2 -> control, huart1 -> camera (projeye gore degistirin). */
-
-    /* I/O: baslat ISR/IT alimi; HAL_UART_Receive_IT geri cagirdiğinde
-       HAL_UART_RxCpltCallback icinde UART_Handler_RxCplt cagirilacak. */
-    HAL_UART_Receive_IT(&huart2, &ctrl_rx_byte, 1U);
-    HAL_UART_Receive_IT(&huart1, &cam_rx_byte, 1U);
+#if (UART_IRQ_CYCLE_STATS == 1)
+    /* DWT cevrim sayacini ac */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CYCCNT = 0U;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#endif
+
+    /* huart2 -> control, huart1 -> camera (projeye gore degistirin).
+       Her olayda HAL_UARTEx_RxEventCallback icinde UART_Handler_RxEvent cagirilacak. */
+    rx_dma_start(&rx_port[UART_PORT_CONTROL]);
+    rx_dma_start(&rx_port[UART_PORT_CAMERA]);
 }
 
-/* Bu fonksiyonu HAL_UART_RxCpltCallback icinden cagirin.
+/* Bu fonksiyonu HAL_UARTEx_RxEventCallback icinden cagirin.
    Ornek ekleme:
-   void HAL_UART_RxCpltCallback(UART_HandleTypeDef *huart)
+   void HAL_UARTEx_RxEventCallback(UART_HandleTypeDef *huart, uint16_t Size)
    {
-       UART_Handler_RxCplt(huart);
+       UART_Handler_RxEvent(huart, Size);
    }
 */
-void UART_Handler_RxCplt(UART_HandleTypeDef *huart)
+void UART_Handler_RxEvent(UART_HandleTypeDef *huart, uint16_t pos)
 {
     if (huart == &vehicle_uart)
     {
-        control_rx_put_byte(ctrl_rx_byte);
-        HAL_UART_Receive_IT(&huart2, &ctrl_rx_byte, 1U);
+        rx_dma_consume(&rx_port[UART_PORT_CONTROL], pos, control_rx_step);
     }
     else if (huart == &cam_uart)
     {
-        camera_rx_put_byte(cam_rx_byte);
-        HAL_UART_Receive_IT(&huart1, &cam_rx_byte, 1U);
+        rx_dma_consume(&rx_port[UART_PORT_CAMERA], pos, camera_rx_step);
+    }
+}
+
+/* USART IRQ'dan (HAL_UART_IRQHandler'dan once) RTOF set oldugunda cagrilir.
+   Hat gap_bits boyunca bosta kaldi: DMA'da bekleyen bytelari framer'a ver,
+   hala yarim kalan aday varsa birak. RTOF HAL'e ulasmaz; ulasirsa HAL onu
+   bloklayici hata sayip DMA alimini durdurur. */
+void UART_Handler_RxTimeout(UART_HandleTypeDef *huart)
+{
+    uart_rx_port_t *p = rx_port_of(huart);
+    uint16_t pos;
+
+    if (p == NULL) {
+        return;
+    }
+
+    pos = (uint16_t)(UART_RX_DMA_BUFFER_SIZE - __HAL_DMA_GET_COUNTER(huart->hdmarx));
+    rx_dma_consume(p, pos, rx_step_of(p));
+    rx_gap_abort(p);
+}
+
+bool UART_Handler_IrqLL(UART_HandleTypeDef *huart)
+{
+    uart_rx_port_t *p = rx_port_of(huart);
+    USART_TypeDef *regs;
+    framer_step_t step;
+    uint32_t isr;
+
+    if (p == NULL) {
+        return false;
+    }
+
+    regs = huart->Instance;
+    step = rx_step_of(p);
+    isr = regs->ISR;
+
+    /* Hata bayraklari: say ve temizle (ORE kalirsa RXNE kesmesi surekli tetiklenir) */
+    if ((isr & (USART_ISR_ORE | USART_ISR_FE | USART_ISR_NE | USART_ISR_PE)) != 0U) {
+        regs->ICR = USART_ICR_ORECF | USART_ICR_FECF | USART_ICR_NECF | USART_ICR_PECF;
+        rx_error_account(p,
+            (((isr & USART_ISR_ORE) != 0U) ? HAL_UART_ERROR_ORE : 0U) |
+            (((isr & USART_ISR_FE) != 0U) ? HAL_UART_ERROR_FE : 0U) |
+            (((isr & USART_ISR_NE) != 0U) ? HAL_UART_ERROR_NE : 0U) |
+            (((isr & USART_ISR_PE) != 0U) ? HAL_UART_ERROR_PE : 0U));
+    }
+
+    /* Gelen her byte: RDR -> halka -> framer */
+    while ((isr & USART_ISR_RXNE) != 0U) {
+        p->ring[p->total & UART_RX_RING_MASK] = (uint8_t)regs->RDR;
+        framer_feed(p, step, p->total);
+        p->total++;
+        isr = regs->ISR;
+    }
+
+    /* Hat bosta: yarim frame'i birak */
+    if ((isr & USART_ISR_RTOF) != 0U) {
+        regs->ICR = USART_ICR_RTOCF;
+        rx_gap_abort(p);
+    }
+
+    /* TX DMA sonrasi TC kesmesi HAL'in isi (HAL_UART_TxCpltCallback) */
+    return !(((isr & USART_ISR_TC) != 0U) && ((regs->CR1 & USART_CR1_TCIE) != 0U));
+}
+
+void UART_Handler_IrqCycles(UART_HandleTypeDef *huart, uint32_t cycles)
+{
+    uart_rx_port_t *p = rx_port_of(huart);
+
+    if (p == NULL) {
+        return;
+    }
+
+    p->irq_stats.irq_count++;
+    p->irq_stats.cycles_last = cycles;
+    p->irq_stats.cycles_total += cycles;
+    if (cycles > p->irq_stats.cycles_max) {
+        p->irq_stats.cycles_max = cycles;
+    }
+}
+
+void UART_GetErrorStats(UartPort_t port, UartErrorStats_t *stats)
+{
+    uint32_t primask;
+
+    if ((port >= UART_PORT_COUNT) || (stats == NULL)) {
+        return;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    *stats = rx_port[port].errors;
+    stats->frames_dropped = rx_port[port].dropped + rx_port[port].stale;
+    __set_PRIMASK(primask);
+}
+
+void UART_ResetErrorStats(UartPort_t port)
+{
+    uint32_t primask;
+
+    if (port >= UART_PORT_COUNT) {
+        return;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    (void)memset(&rx_port[port].errors, 0, sizeof(rx_port[port].errors));
+    rx_port[port].dropped = 0U;
+    rx_port[port].stale = 0U;
+    __set_PRIMASK(primask);
+}
+
+void UART_GetIrqStats(UartPort_t port, UartIrqStats_t *stats)
+{
+    uint32_t primask;
+
+    if ((port >= UART_PORT_COUNT) || (stats == NULL)) {
+        return;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+    *stats = rx_port[port].irq_stats;
+    __set_PRIMASK(primask);
+}
+
+void UART_SetRxGapBits(UartPort_t port, uint32_t gap_bits)
+{
+    if ((port < UART_PORT_COUNT) && (gap_bits > 0U) && (gap_bits <= USART_RTOR_RTO)) {
+        rx_port[port].gap_bits = gap_bits;
+        HAL_UART_ReceiverTimeout_Config(rx_port[port].huart, gap_bits);
+    }
+}
+
+uint32_t UART_GetRxGapAbortCount(UartPort_t port)
+{
+    if (port < UART_PORT_COUNT) {
+        return rx_port[port].gap_aborts;
     }
+    return 0U;
 }
+
 void HAL_UART_ErrorCallback(UART_HandleTypeDef *huart){
-	if(huart == &cam_uart){
-		HAL_UART_Receive_IT(&huart1, &cam_rx_byte, 1U);
-	}else if(huart == &vehicle_uart){
-		HAL_UART_Receive_IT(&huart2, &ctrl_rx_byte, 1U);
+	uart_tx_queue_t *q = tx_queue_of(huart);
+	uart_rx_port_t *p = rx_port_of(huart);
+
+	if(p != NULL){
+		/* Hata sayaclari + yarim frame'in birakilmasi */
+		rx_error_account(p, huart->ErrorCode);
+
+		/* DMA modunda alim hatasi alimi durdurur; dairesel alimi bastan kur.
+		   Sadece TX hatasinda alim calismaya devam eder, dokunma. */
+		if(huart->RxState == HAL_UART_STATE_READY){
+			rx_dma_start(p);
+			p->errors.recoveries++;
+		}
+	}
+	/* TX DMA hatasi: aktif frame'i birak, kuyruk tikanmasin */
+	if((q != NULL) && q->busy && (huart->gState == HAL_UART_STATE_READY)){
+		UART_Handler_TxCplt(huart);
 	}
 }
-/* Gonderme: kameraya veriyi yazar */
-bool UART_SendToCamera(const uint8_t *data, uint16_t len)
+
+void UART_Handler_TxCplt(UART_HandleTypeDef *huart)
 {
-    if ((data == NULL) || (len == 0U)) {
-        return false;
+    uart_tx_queue_t *q = tx_queue_of(huart);
+    const uint8_t *done_data;
+    uint16_t done_len;
+
+    if ((q == NULL) || (q->count == 0U)) {
+        return;
+    }
+
+    done_data = q->data[q->tail];
+    done_len = q->len[q->tail];
+    q->tail = (uint8_t)((q->tail + 1U) % UART_TX_QUEUE_DEPTH);
+    q->count--;
+    q->busy = false;
+
+    /* Bekleyen varsa hatta bosluk birakmadan hemen baslat */
+    tx_start_next(q);
+
+    if (q->on_complete != NULL) {
+        q->on_complete((q == &tx_queue[UART_PORT_CONTROL]) ? UART_PORT_CONTROL : UART_PORT_CAMERA,
+                       done_data, done_len);
+    }
+}
+
+
+void UART_Handler_Process(void)
+{
+    /* Onceki turda kontrol kuyruguna sigmayan yanit kopyalari, sonra kamera
+       yanitlari: bekleyen komut kuyrugunu bosaltir */
+    ctrl_fanout_flush();
+    rx_frame_drain(&rx_port[UART_PORT_CAMERA], rx_camera_frame);
+
+    /* Acilan kredilerle sirada bekleyen kamera komutlarini gonder
+       (yeni kontrol frame'lerinden once, gelis sirasi korunur) */
+    CamSched_Process();
+
+    rx_frame_drain(&rx_port[UART_PORT_CONTROL], rx_control_frame);
+}
+
+uint32_t UART_GetRxFrameDropCount(UartPort_t port)
+{
+    if (port < UART_PORT_COUNT) {
+        return rx_port[port].dropped + rx_port[port].stale;
+    }
+    return 0U;
+}
+
+uint32_t UART_GetRxResyncCount(UartPort_t port)
+{
+    if (port < UART_PORT_COUNT) {
+        return rx_port[port].resyncs;
+    }
+    return 0U;
+}
+
+const uint8_t *FrameView_Linear(const FrameView_t *view, uint8_t *scratch)
+{
+    uint16_t first = (uint16_t)(view->seq & UART_RX_RING_MASK);
+    uint16_t head_len;
+
+    if ((uint32_t)first + view->len <= UART_RX_DMA_BUFFER_SIZE) {
+        /* Bolunmemis frame: dogrudan halkadaki yerine isaret et */
+        return &view->ring[first];
+    }
+
+    /* Halka sonunda bolunmus frame: iki parcayi scratch'e birlestir */
+    head_len = (uint16_t)(UART_RX_DMA_BUFFER_SIZE - first);
+    (void)memcpy(scratch, &view->ring[first], head_len);
+    (void)memcpy(&scratch[head_len], view->ring, (size_t)view->len - head_len);
+    return scratch;
+}
+
+/* ISR: tamamlanan aday frame'in gorunumunu kuyruga birakir; kuyruk doluysa atilir */
+static void rx_frame_push(uart_rx_port_t *p)
+{
+    FrameView_t *v;
+
+    if ((uint8_t)(p->head - p->tail) >= UART_RX_FRAME_QUEUE_DEPTH) {
+        p->dropped++;
+        return;
+    }
+
+    v = &p->frames[p->head & (UART_RX_FRAME_QUEUE_DEPTH - 1U)];
+    v->ring = p->ring;
+    v->seq = p->start;
+    v->len = p->len;
+    __DMB(); /* gorunum, head guncellenmeden once yazilmis olmali */
+    p->head++;
+}
+
+/* Ana dongu: kuyruktaki tum frame'leri sirayla, halkadaki yerinde isler.
+   Handler frame'i yerinde okur (memo, bekleyen komut kaydi, siraya kopya);
+   o sirada DMA'nin ulasabilecegi frame'ler once scratch'e alinir. */
+static void rx_frame_drain(uart_rx_port_t *p, void (*handle)(const uint8_t *, uint16_t))
+{
+    uint8_t scratch[CAMERA_RX_BUFFER_SIZE];
+    const FrameView_t *v;
+    const uint8_t *pkt;
+    uint32_t ahead;
+
+    while (p->tail != p->head) {
+        v = &p->frames[p->tail & (UART_RX_FRAME_QUEUE_DEPTH - 1U)];
+
+        /* DMA halkayi bir tur doldurup frame'in uzerine yazdiysa isleme */
+        ahead = rx_dma_written(p) - v->seq;
+        if (ahead > UART_RX_DMA_BUFFER_SIZE) {
+            p->stale++;
+        } else {
+            pkt = FrameView_Linear(v, scratch);
+            if (pkt == scratch) {
+                p->wrapped++;
+            } else if ((ahead + UART_RX_COPY_MARGIN) > UART_RX_DMA_BUFFER_SIZE) {
+                (void)memcpy(scratch, pkt, v->len);
+                pkt = scratch;
+                p->copied++;
+            }
+            /* Kopya sirasinda uzerine yazildiysa checksum'i gecersizdir */
+            if ((pkt == scratch) && ((rx_dma_written(p) - v->seq) > UART_RX_DMA_BUFFER_SIZE)) {
+                p->stale++;
+            } else {
+                handle(pkt, v->len);
+            }
+        }
+        __DMB();
+        p->tail++;
+    }
+}
+
+/* Dairesel DMA + IDLE alimini (yeniden) baslatir */
+static void rx_dma_start(uart_rx_port_t *p)
+{
+    reset_framer(p);
+#if (UART_DRIVER_LL == 1)
+    /* Register seviyesi: DMA yok, her byte RXNE kesmesiyle halkaya yazilir */
+    p->dma_pos = 0U;
+    p->huart->Instance->ICR = USART_ICR_ORECF | USART_ICR_FECF | USART_ICR_NECF | USART_ICR_PECF;
+    SET_BIT(p->huart->Instance->CR3, USART_CR3_EIE);
+    SET_BIT(p->huart->Instance->CR1, USART_CR1_RXNEIE);
+#else
+    /* DMA halkanin basindan yazar: mutlak sira (total) halka indeksiyle
+       hizali kalsin diye bir sonraki tur basina yuvarlanir */
+    p->total = (p->total + UART_RX_RING_MASK) & ~(uint32_t)UART_RX_RING_MASK;
+    p->dma_pos = 0U;
+    (void)HAL_UARTEx_ReceiveToIdle_DMA(p->huart, p->ring, UART_RX_DMA_BUFFER_SIZE);
+#endif
+    rx_gap_start(p);
+}
+
+/* Hat gap_bits boyunca bosta kaldi: yarim kalan aday varsa birak */
+static void rx_gap_abort(uart_rx_port_t *p)
+{
+    if (p->len > 0U) {
+        reset_framer(p);
+        p->gap_aborts++;
+    }
+}
+
+/* Hat hatasi: turune gore say, toplanmakta olan frame'i birak.
+   Kayip/bozuk byte iceren aday zaten checksum'dan gecemez; framer
+   tutarli bir baslangic durumuna doner. */
+static void rx_error_account(uart_rx_port_t *p, uint32_t error_code)
+{
+    if ((error_code & HAL_UART_ERROR_ORE) != 0U) { p->errors.ore++; }
+    if ((error_code & HAL_UART_ERROR_FE) != 0U)  { p->errors.fe++; }
+    if ((error_code & HAL_UART_ERROR_NE) != 0U)  { p->errors.ne++; }
+    if ((error_code & HAL_UART_ERROR_PE) != 0U)  { p->errors.pe++; }
+    if ((error_code & HAL_UART_ERROR_DMA) != 0U) { p->errors.dma++; }
+
+    if ((error_code & (HAL_UART_ERROR_ORE | HAL_UART_ERROR_FE |
+                       HAL_UART_ERROR_NE | HAL_UART_ERROR_PE)) != 0U) {
+        if (p->len > 0U) {
+            p->errors.frames_aborted++;
+        }
+        reset_framer(p);
+    }
+}
+
+static framer_step_t rx_step_of(const uart_rx_port_t *p)
+{
+    return (p == &rx_port[UART_PORT_CONTROL]) ? control_rx_step : camera_rx_step;
+}
+
+/* USART receiver timeout: son stop bitinden gap_bits bit suresi sonra RTOF.
+   ReceiveToIdle_DMA RTOIE'yi acmaz; her (yeniden) baslatmada kurulur. */
+static void rx_gap_start(uart_rx_port_t *p)
+{
+    HAL_UART_ReceiverTimeout_Config(p->huart, p->gap_bits);
+    SET_BIT(p->huart->Instance->CR2, USART_CR2_RTOEN);
+    __HAL_UART_CLEAR_FLAG(p->huart, UART_CLEAR_RTOF);
+    __HAL_UART_ENABLE_IT(p->huart, UART_IT_RTO);
+}
+
+static uart_rx_port_t *rx_port_of(const UART_HandleTypeDef *huart)
+{
+    if (huart == &vehicle_uart) {
+        return &rx_port[UART_PORT_CONTROL];
+    }
+    if (huart == &cam_uart) {
+        return &rx_port[UART_PORT_CAMERA];
     }
+    return NULL;
+}
+
+/* DMA'nin dma_pos..pos arasina yazdigi bytelari (sarma dahil) framer'a verir */
+static void rx_dma_consume(uart_rx_port_t *p, uint16_t pos, framer_step_t step)
+{
+    uint16_t idx = p->dma_pos;
+    uint16_t end = (uint16_t)(pos & UART_RX_RING_MASK); /* TC olayinda pos == boyut */
 
-    /* Non-blocking gonderim istenirse HAL_UART_Transmit_IT kullanin.
-       Burada bloklayici kullanimi kolaylik icin tercih edildi. */
-    if (HAL_UART_Transmit(&huart1, (uint8_t *)data, (uint16_t)len, 500U) == HAL_OK) {
-        return true;
+    while (idx != end) {
+        framer_feed(p, step, p->total);
+        p->total++;
+        idx = (uint16_t)((idx + 1U) & UART_RX_RING_MASK);
     }
+    p->dma_pos = end;
+}
+
+/* Port uzerinde DMA'nin su ana kadar yazdigi toplam byte (mutlak sira) */
+static uint32_t rx_dma_written(const uart_rx_port_t *p)
+{
+#if (UART_DRIVER_LL == 1)
+    /* Register seviyesi: total her byte'ta guncel */
+    return p->total;
+#else
+    uint32_t primask = __get_PRIMASK();
+    uint32_t written;
+    uint16_t dma_now;
+
+    __disable_irq();
+    dma_now = (uint16_t)(UART_RX_DMA_BUFFER_SIZE - __HAL_DMA_GET_COUNTER(p->huart->hdmarx));
+    written = p->total + ((uint32_t)(dma_now - p->dma_pos) & UART_RX_RING_MASK);
+    __set_PRIMASK(primask);
+
+    return written;
+#endif
+}
 
-    return false;
+/* Gonderme: kameraya veriyi yazar (kuyruga ekler, bloklamaz) */
+bool UART_SendToCamera(const uint8_t *data, uint16_t len)
+{
+    return tx_enqueue(&tx_queue[UART_PORT_CAMERA], data, len, true);
 }
 
-/* Gonderme: kontrole veriyi yazar */
+/* Gonderme: kontrole veriyi yazar (kuyruga ekler, bloklamaz) */
 bool UART_SendToControl(const uint8_t *data, uint16_t len)
 {
-    if ((data == NULL) || (len == 0U)) {
+    return tx_enqueue(&tx_queue[UART_PORT_CONTROL], data, len, true);
+}
+
+/* Sabit (flash) frame: kopyalanmaz, DMA dogrudan data'dan okur */
+bool UART_SendToCameraStatic(const uint8_t *data, uint16_t len)
+{
+    return tx_enqueue(&tx_queue[UART_PORT_CAMERA], data, len, false);
+}
+
+bool UART_SendToControlStatic(const uint8_t *data, uint16_t len)
+{
+    return tx_enqueue(&tx_queue[UART_PORT_CONTROL], data, len, false);
+}
+
+void UART_RegisterTxCompleteCallback(UartPort_t port, UartTxCompleteCb_t cb)
+{
+    if (port < UART_PORT_COUNT) {
+        tx_queue[port].on_complete = cb;
+    }
+}
+
+uint32_t UART_GetTxQueueDepth(UartPort_t port)
+{
+    return (port < UART_PORT_COUNT) ? (uint32_t)tx_queue[port].count : 0U;
+}
+
+uint32_t UART_GetTxQueuePeak(UartPort_t port)
+{
+    return (port < UART_PORT_COUNT) ? (uint32_t)tx_queue[port].peak : 0U;
+}
+
+uint32_t UART_GetTxDropCount(UartPort_t port)
+{
+    return (port < UART_PORT_COUNT) ? tx_queue[port].dropped : 0U;
+}
+
+static uart_tx_queue_t *tx_queue_of(const UART_HandleTypeDef *huart)
+{
+    if (huart == &vehicle_uart) {
+        return &tx_queue[UART_PORT_CONTROL];
+    }
+    if (huart == &cam_uart) {
+        return &tx_queue[UART_PORT_CAMERA];
+    }
+    return NULL;
+}
+
+/* Frame'i bos slot'a kopyalar (copy == false ise sadece pointer'i alir:
+   flash'taki sabit frame) ve DMA bostaysa gonderimi baslatir.
+   Hem ISR hem ana donguden cagrilabilir; kuyruk islemleri kesmeler kapali yapilir. */
+static bool tx_enqueue(uart_tx_queue_t *q, const uint8_t *data, uint16_t len, bool copy)
+{
+    uint32_t primask;
+    uint8_t idx;
+
+    if ((data == NULL) || (len == 0U) || (copy && (len > UART_TX_SLOT_SIZE))) {
+        return false;
+    }
+
+    primask = __get_PRIMASK();
+    __disable_irq();
+
+    if (q->count >= UART_TX_QUEUE_DEPTH) {
+        q->dropped++;
+        __set_PRIMASK(primask);
         return false;
     }
 
-    if (HAL_UART_Transmit(&huart2, (uint8_t *)data, (uint16_t)len, 500U) == HAL_OK) {
-        return true;
+    idx = q->head;
+    if (copy) {
+        (void)memcpy(q->slot[idx], data, len);
+        q->data[idx] = q->slot[idx];
+    } else {
+        q->data[idx] = data;
     }
+    q->len[idx] = len;
+    q->head = (uint8_t)((q->head + 1U) % UART_TX_QUEUE_DEPTH);
+    q->count++;
+    if (q->count > q->peak) {
+        q->peak = q->count;
+    }
+
+    tx_start_next(q);
 
-    return false;
+    __set_PRIMASK(primask);
+    return true;
 }
 
-/* Bu fonksiyonlar, tam bir paket tespit edildiginde cagirilir. */
+/* DMA bos ve kuyrukta frame varsa en eskisini gonderir */
+static void tx_start_next(uart_tx_queue_t *q)
+{
+    if (q->busy || (q->count == 0U)) {
+        return;
+    }
+
+    q->busy = true;
+    if (HAL_UART_Transmit_DMA(q->huart, (uint8_t *)q->data[q->tail], q->len[q->tail]) != HAL_OK) {
+        /* Baslatilamadi: frame'i birak, kuyrugu kilitleme */
+        q->busy = false;
+        q->tail = (uint8_t)((q->tail + 1U) % UART_TX_QUEUE_DEPTH);
+        q->count--;
+        q->dropped++;
+    }
+}
+
+
+/* Bu fonksiyonlar, tam bir paket tespit edildiginde ana donguden cagirilir. */
 /* Paket doğrulama + çeviri + gönderme burada yapılıyor. */
 
-void UART_HandleControlPacket(const uint8_t *pkt, uint16_t len)
+void UART_HandleControlFrame(const CtrlPacketView_t *view)
 {
-    uint8_t cam_pkt[64]={0};
+    uint8_t cam_pkt[64];
+    const uint8_t *cam_frame = NULL;
     uint8_t cam_len = 0U;
+    cmdBlock_t req;
     TranslationResult_t tr;
 
-    /* Paket dogrula */
-    if (!VerifyCtrlPacket(pkt, (uint8_t)len)) {
-        /* gecerli degilse atla (istege gore hata logu ekle) */
-        return;
-    }
-    /* Cevir kontrol->kamera */
-    tr = CommandHandler_TranslateCtrlToCam(pkt, (uint8_t)len, cam_pkt, &cam_len);
+    /* Cevir kontrol->kamera (gorunum framer'da dogrulandi, tekrar bakilmaz) */
+    tr = CommandHandler_PrepareCtrlView(view, cam_pkt, &cam_frame, &cam_len, &req);
     if (tr != TRANSLATION_OK) {
     	//TODO: Bu noktada hata log çıktısı verilebilir.
         /* hatali ceviri, isleme devam etme */
         return;
     }
 
-    /* Kameraya gonder */
-    (void)UART_SendToCamera(cam_pkt, (uint16_t)cam_len);
+    /* Kameraya gonder (pencere: kredi yoksa sirada bekler). Hazir frame
+       flash'tan kopyasiz, uretilen frame slot'a / siraya kopyalanir */
+    (void)CamSched_Submit(cam_frame, cam_len, (cam_frame != cam_pkt), &req);
 }
 
-void UART_HandleCameraPacket(const uint8_t *pkt, uint16_t len)
+void UART_HandleCameraFrame(const CamPacketView_t *view)
 {
     uint8_t ctrl_resp[64];
+    const uint8_t *ctrl_frame = NULL;
     uint8_t ctrl_len = 0U;
+    uint16_t copies = 1U;
+    ctrl_fanout_item_t *item;
     TranslationResult_t tr;
 
-    /* Paket dogrula */
-    if (!VerifyCamPacket(pkt, (uint8_t)len)) {
+    /* Kamera yaniti isle ve eski formata cevir */
+    tr = CommandHandler_ProcessCamResponseView(view, ctrl_resp, &ctrl_frame, &ctrl_len, &copies);
+    if ((tr == TRANSLATION_OK) || (tr == TRANSLATION_ERROR)) {
+        /* Bekleyen komut kapandi: kredi geri dondu */
+        CamSched_OnResponse();
+    }
+    if (tr != TRANSLATION_OK) {
         return;
     }
 
-    /* Kamera yaniti isle ve eski formata cevir */
-    tr = CommandHandler_ProcessCamResponse(pkt, (uint8_t)len, ctrl_resp, &ctrl_len);
-    if (tr != TRANSLATION_OK) {
+    /* Kontrole gonder: sabit yanit flash'tan kopyasiz. Tek ucus okumasinda
+       ayni yanit bekleyen her istek icin bir kez daha gider. Onceki
+       yanitlarin kalan kopyalari once gider (sira korunur); kuyruga
+       sigmayanlar siraya alinir, UART_Handler_Process'te gonderilir */
+    ctrl_fanout_flush();
+    if ((uint8_t)(ctrl_fanout.head - ctrl_fanout.tail) >= CTRL_FANOUT_DEPTH) {
+        ctrl_fanout.dropped += copies;
         return;
     }
 
-    /* Kontrole gonder */
-    (void)UART_SendToControl(ctrl_resp, (uint16_t)ctrl_len);
+    item = &ctrl_fanout.items[ctrl_fanout.head & (CTRL_FANOUT_DEPTH - 1U)];
+    if (ctrl_frame != ctrl_resp) {
+        item->frame = ctrl_frame;
+    } else {
+        (void)memcpy(item->bytes, ctrl_resp, ctrl_len);
+        item->frame = item->bytes;
+    }
+    item->len = ctrl_len;
+    item->left = (uint8_t)copies;
+    ctrl_fanout.head++;
+    ctrl_fanout_flush();
 }
 
+void UART_HandleControlPacket(const uint8_t *pkt, uint16_t len)
+{
+    CtrlPacketView_t view;
+
+    /* Framer disindan gelen bytelar: bir kez dogrula */
+    (void)CtrlPacketView_Parse(&view, pkt, len);
+    UART_HandleControlFrame(&view);
+}
 
-static void reset_control_buffer(void)
+void UART_HandleCameraPacket(const uint8_t *pkt, uint16_t len)
 {
-    (void)memset(control_rx_buf, 0, sizeof(control_rx_buf));
-    control_rx_len = 0U;
+    CamPacketView_t view;
+
+    (void)CamPacketView_Parse(&view, pkt, len);
+    UART_HandleCameraFrame(&view);
 }
 
-static void reset_camera_buffer(void)
+/* Framer'dan gelen frame: trailer ve checksum ISR'da kontrol edildi,
+   gorunum dogrulanmis olarak kurulur */
+static void rx_control_frame(const uint8_t *pkt, uint16_t len)
 {
-    (void)memset(camera_rx_buf, 0, sizeof(camera_rx_buf));
-    camera_rx_len = 0U;
+    CtrlPacketView_t view;
+
+    CtrlPacketView_Init(&view, pkt, len, true);
+    UART_HandleControlFrame(&view);
 }
 
-/* Her gelen byte control tarafina gelir */
-static void control_rx_put_byte(uint8_t b)
+/* Bekleyen yanit kopyalarini gelis sirasiyla, kontrol kuyrugu kabul ettigi
+   kadar gonder */
+static void ctrl_fanout_flush(void)
 {
-	static uint32_t last_time = 0;
-    static uint16_t index = 0;
-    uint32_t now = HAL_GetTick(); // ms cinsinden zaman
-    //  Timeout kontrolü: 50 ms boyunca veri gelmezse resetle
-    if (now - last_time > 50 && control_rx_len>0) {
-//        debugger("UART timeout! Buffer temizleniyor.\r\n");
-        reset_control_buffer();
-        index = 0;
+    ctrl_fanout_item_t *item;
+    bool ok;
+
+    while (ctrl_fanout.tail != ctrl_fanout.head) {
+        item = &ctrl_fanout.items[ctrl_fanout.tail & (CTRL_FANOUT_DEPTH - 1U)];
+        while (item->left != 0U) {
+            ok = (item->frame == item->bytes)
+                     ? UART_SendToControl(item->bytes, (uint16_t)item->len)
+                     : UART_SendToControlStatic(item->frame, (uint16_t)item->len);
+            if (!ok) {
+                return;     /* kuyruk dolu: sonraki turda */
+            }
+            item->left--;
+        }
+        ctrl_fanout.tail++;
     }
-    last_time = now; // son veri zamanı güncelle
-    /* Baslangic aranir: control paketleri genelde 0xAA ile baslar */
+}
+
+static void rx_camera_frame(const uint8_t *pkt, uint16_t len)
+{
+    CamPacketView_t view;
+
+    CamPacketView_Init(&view, pkt, len, true);
+    UART_HandleCameraFrame(&view);
+}
+
+
+/* Aday frame'i birakir (kopya/temizleme yok, sadece sayaclar) */
+static void reset_framer(uart_rx_port_t *p)
+{
+    p->len = 0U;
+    p->expected = 0U;
+    p->csum = 0U;
+}
+
+/* Aday frame'in i. byte'i (halka uzerinde) */
+static inline uint8_t framer_at(const uart_rx_port_t *p, uint16_t i)
+{
+    return p->ring[(p->start + i) & UART_RX_RING_MASK];
+}
+
+/* Bir byte'i framer'a verir (seq: byte'in porttaki mutlak sirasi).
+   Aday frame gecersiz cikarsa (bozuk LEN, trailer veya checksum) aday
+   atilmaz: baslangicin bir sonrasindan itibaren halkada duran bytelar
+   yeniden taranir (artimli checksum da yeni adayla sifirdan kurulur). Boylece bozuk frame'in icinde baslamis gecerli bir
+   frame kaybolmaz. Her geri cekilmede baslangic en az bir ilerledigi
+   icin tarama sonludur. */
+static void framer_feed(uart_rx_port_t *p, framer_step_t step, uint32_t seq)
+{
+    uint32_t pos = seq;
+
+    while (pos != (seq + 1U)) {
+        if (step(p, p->ring[pos & UART_RX_RING_MASK], pos) == FRAMER_RESYNC) {
+            pos = p->start + 1U;
+            reset_framer(p);
+            p->resyncs++;
+        } else {
+            pos++;
+        }
+    }
+}
 
-    if (control_rx_len == 0U) {
-        if (b != 0xAAU && b != 0x55U) { /* bazen 0x55 da gelebilir, tolere edelim */
+/* Her gelen byte control tarafina gelir.
+   Cerceve: [AA/55] [LEN] ... [CS] EB AA, toplam boy = LEN + CTRL_PKT_LEN_OVERHEAD */
+static framer_status_t control_rx_step(uart_rx_port_t *p, uint8_t b, uint32_t seq)
+{
+    /* Baslangic aranir: control paketleri genelde 0xAA ile baslar */
+    if (p->len == 0U) {
+        if (b != CTRL_PKT_START_AA && b != CTRL_PKT_START_55) { /* bazen 0x55 da gelebilir, tolere edelim */
             /* baslangic degil -> ignore */
-        	// TODO: Log: Paket geçersiz!
-            return;
+            return FRAMER_IDLE;
         }
+        p->start = seq;
     }
-    /* Buffer ta dolma kontrolu */
-    if (control_rx_len < CONTROL_RX_BUFFER_SIZE) {
-        control_rx_buf[control_rx_len++] = b;
-    } else {
-        /* taştı -> reset */
-    	// TODO: debugger("\nPaket boyutu uzun!\r\n");
-        reset_control_buffer();
-        return;
+
+    p->len++;
+
+    /* START ve LEN her zaman checksum'a girer */
+    if (p->len == 1U) {
+        p->csum = b;
+        return FRAMER_BUSY;
     }
-    /* Paket sonu kontrolu: control paketlerinde son iki byte EB AA */
-    if (control_rx_len >= 2U) {
-        if ((control_rx_buf[control_rx_len - 2U] == 0xEBU) &&
-            (control_rx_buf[control_rx_len - 1U] == 0xAAU)) {
-            /* Tam paket alindi */
-            UART_HandleControlPacket(control_rx_buf, control_rx_len);
-            reset_control_buffer();
+
+    /* LEN geldi: beklenen toplam boyu hesapla, sigmayacak/kisa boylari hemen reddet */
+    if (p->len == 2U) {
+        p->csum = (uint8_t)(p->csum + b);
+        p->expected = (uint16_t)b + CTRL_PKT_LEN_OVERHEAD;
+        if ((p->expected < CTRL_PKT_MIN_SIZE) || (p->expected > CONTROL_RX_BUFFER_SIZE)) {
+            return FRAMER_RESYNC;
         }
+        return FRAMER_BUSY;
+    }
+
+    /* Govde: 0..len-4 bytelari toplama eklenir, CS byte'i (len-3) gelince karsilastirilir */
+    if (p->len < p->expected) {
+        if (p->len < (uint16_t)(p->expected - 2U)) {
+            p->csum = (uint8_t)(p->csum + b);
+        } else if ((p->len == (uint16_t)(p->expected - 2U)) && (b != p->csum)) {
+            return FRAMER_RESYNC;
+        }
+        return FRAMER_BUSY;
+    }
+
+    /* Beklenen boya ulasildi: checksum zaten dogru, sadece EB AA trailer */
+    if ((framer_at(p, (uint16_t)(p->len - 2U)) != CTRL_PKT_END_EB) || (b != CTRL_PKT_END_AA)) {
+        return FRAMER_RESYNC;
     }
-//        else {
-//            /* long packets: bazı kontrol paketleri büyük olabilir; ayrıca checksum
-//               kontrolu ve length field'e göre erken tamamlama yapabilirsiniz.
-//               Örnegin packet[1] length bilgisine bakıp (packet[1] + offset) kullanmak daha doğru. */
-//            /* Alternatif: eger buffer[1] = len (sayac) ise o uzunluga gore de tetikleyin */
-//            if (control_rx_len >= 2U) {
-//                uint8_t indicated_len = control_rx_buf[1U];
-//                /* indicated_len: Kontrol protokolu tanimina gore boyut kontrolu */
-//                /* Burada sadece basit kontrol: eger indicated_len+3 == control_rx_len -> tam paket */
-//                /* Not: Gelen formatlarda LEN tanimina gore degisebilir, uyarlayin. */
-//                if (indicated_len > 0U) {
-//                    uint16_t expected_total = (uint16_t)indicated_len + 2U; /* ornek hesaplama */
-//                    if (control_rx_len >= expected_total) {
-//                        /* Paket bitti varsayimi */
-//                        UART_HandleControlPacket(control_rx_buf, control_rx_len);
-//                        reset_control_buffer();
-//                    }
-//                }
-//            }
-//        }
-//    }
-}
-
-/* Her gelen byte kamera tarafina gelir */
-static void camera_rx_put_byte(uint8_t b)
+
+    /* Tam paket alindi: isleme ana dongude */
+    rx_frame_push(p);
+    reset_framer(p);
+    return FRAMER_IDLE;
+}
+
+/* Her gelen byte kamera tarafina gelir.
+   Cerceve: 55 AA [LEN] ... [XOR] F0, toplam boy = LEN + CAM_PKT_LEN_OVERHEAD */
+static framer_status_t camera_rx_step(uart_rx_port_t *p, uint8_t b, uint32_t seq)
 {
     /* Kamera paketleri 0x55 0xAA ile baslar */
-    if (camera_rx_len == 0U) {
-        if (b != 0x55U) {
-            return;
+    if (p->len == 0U) {
+        if (b != CAM_PKT_START1) {
+            return FRAMER_IDLE;
         }
-    } else if (camera_rx_len == 1U) {
-        if (b != 0xAAU) {
-            /* baslangic hatasi -> reset */
-            reset_camera_buffer();
-            return;
+        p->start = seq;
+    } else if (p->len == 1U) {
+        if (b != CAM_PKT_START2) {
+            /* baslangic hatasi -> bu byte yeni baslangic olabilir */
+            return FRAMER_RESYNC;
         }
     }
 
-    if (camera_rx_len < CAMERA_RX_BUFFER_SIZE) {
-        camera_rx_buf[camera_rx_len++] = b;
-    } else {
-        reset_camera_buffer();
-        return;
+    p->len++;
+
+    /* LEN geldi (3. byte): beklenen toplam boyu hesapla, sigmayacaksa reddet */
+    if (p->len == 3U) {
+        p->csum = b;
+        p->expected = (uint16_t)b + CAM_PKT_LEN_OVERHEAD;
+        if ((b == 0U) || (p->expected > CAMERA_RX_BUFFER_SIZE)) {
+            return FRAMER_RESYNC;
+        }
+        return FRAMER_BUSY;
     }
 
-    /* Kamera paket bitisi F0 (son byte) */
-    if (camera_rx_buf[camera_rx_len - 1U] == 0xF0U) {
-        /* Tam paket alindi */
-        UART_HandleCameraPacket(camera_rx_buf, camera_rx_len);
-        reset_camera_buffer();
-    } else {
-        /* Alternatif: packet[2] length alanina gore hizli bitti kontrolu yapilabilir:
-           if (camera_rx_len >= 3) { expected_len = camera_rx_buf[2]; if (camera_rx_len >= expected_len+2) ... } */
+    if (p->len < 3U) {
+        return FRAMER_BUSY;
+    }
+
+    /* Govde: 2..len-3 bytelari XOR'a girer, XOR byte'i (len-2) gelince karsilastirilir */
+    if (p->len < p->expected) {
+        if (p->len < (uint16_t)(p->expected - 1U)) {
+            p->csum ^= b;
+        } else if (b != p->csum) {
+            return FRAMER_RESYNC;
+        }
+        return FRAMER_BUSY;
     }
+
+    /* Beklenen boya ulasildi: XOR zaten dogru, sadece F0 trailer */
+    if (b != CAM_PKT_END) {
+        return FRAMER_RESYNC;
+    }
+
+    /* Tam paket alindi: isleme ana dongude */
+    rx_frame_push(p);
+    reset_framer(p);
+    return FRAMER_IDLE;
 }
 
 /* End of file */